@@ -0,0 +1,44 @@
+/* cmake.h.in. Creates cmake.h during a cmake run */
+
+/* Package information */
+#define PACKAGE           "timew"
+#define VERSION           "1.7.1-dev"
+#define PACKAGE_BUGREPORT "support@gothenburgbitfactory.org"
+#define PACKAGE_NAME      "timew"
+#define PACKAGE_TARNAME   "timew"
+#define PACKAGE_VERSION   "1.7.1-dev"
+#define PACKAGE_STRING    "timew 1.7.1-dev"
+
+#define CMAKE_BUILD_TYPE  "Debug"
+
+/* git information */
+#define HAVE_COMMIT
+
+/* cmake information */
+#define HAVE_CMAKE
+#define CMAKE_VERSION "3.25.1"
+
+/* Compiling platform */
+#define LINUX
+/* #undef DARWIN */
+/* #undef CYGWIN */
+/* #undef FREEBSD */
+/* #undef OPENBSD */
+/* #undef NETBSD */
+/* #undef DRAGONFLY */
+/* #undef HAIKU */
+/* #undef SOLARIS */
+/* #undef KFREEBSD */
+/* #undef GNUHURD */
+/* #undef UNKNOWN */
+
+/* Found tm.tm_gmtoff struct member */
+/* #undef HAVE_TM_GMTOFF */
+
+/* Found st.st_birthtime struct member */
+/* #undef HAVE_ST_BIRTHTIME */
+
+/* Functions */
+/* #undef HAVE_GET_CURRENT_DIR_NAME */
+/* #undef HAVE_TIMEGM */
+/* #undef HAVE_UUID_UNPARSE_LOWER */
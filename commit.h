@@ -0,0 +1,4 @@
+/* commit.h.in. Creates commit.h during a cmake run */
+
+/* git information */
+#define COMMIT "820ef81"
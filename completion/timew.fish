@@ -57,6 +57,7 @@ export\t'Export tracked time in JSON'
 gaps\t'Display time tracking gaps'
 get\t'Display DOM values'
 help\t'Display help'
+import\t'Import intervals in JSON or data file format'
 week\t'Display chart report'
 join\t'Join intervals'
 lengthen\t'Lengthen intervals'
@@ -26,17 +26,28 @@
 
 #include <AtomicFile.h>
 #include <FS.h>
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cerrno>
 #include <csignal>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <fcntl.h>
 #include <format.h>
 #include <iostream>
+#include <set>
+#include <sys/stat.h>
 #include <timew.h>
 #include <unistd.h>
 #include <vector>
 
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
 struct AtomicFile::impl
 {
   using value_type = std::shared_ptr <AtomicFile::impl>;
@@ -51,6 +62,10 @@ struct AtomicFile::impl
   // the temp file until finalization.
   bool is_temp_active {false};
 
+  // Content to be appended to the real file itself on finalization, instead
+  // of replacing it with the temp file.
+  std::string in_place_content {};
+
   explicit impl (const Path& path);
   ~impl ();
 
@@ -66,9 +81,13 @@ struct AtomicFile::impl
   void read (std::string& content);
   void read (std::vector <std::string>& lines);
   void append (const std::string& content);
+  void append_in_place (const std::string& content);
   void write_raw (const std::string& content);
+  void write_lines (const std::vector <std::string>& lines);
 
   void finalize ();
+  bool finalize_in_place ();
+  void materialize ();
 
   static atomic_files_t::iterator find (const std::string& path) = delete;
   static atomic_files_t::iterator find (const Path& path);
@@ -79,10 +98,175 @@ struct AtomicFile::impl
   // any of them to be copied over the "real" file.
   static bool allow_atomics;
   static atomic_files_t atomic_files;
+
+  // Directories holding files that finalize () changed, to be synced.
+  static std::set <std::string> changed_directories;
 };
 
+static const size_t WRITE_BUFFER_SIZE = 65536;
+
 AtomicFile::impl::atomic_files_t AtomicFile::impl::atomic_files {};
 bool AtomicFile::impl::allow_atomics {true};
+std::set <std::string> AtomicFile::impl::changed_directories {};
+
+AtomicFile::Durability AtomicFile::durability {AtomicFile::Durability::none};
+
+////////////////////////////////////////////////////////////////////////////////
+// Flushes the file or directory at path to disk. With 'filesystem', the whole
+// file system it is on is flushed, where the platform supports that.
+static void sync (const std::string& path, bool filesystem)
+{
+  int fd = ::open (path.c_str (), O_RDONLY | O_CLOEXEC);
+  bool failed = fd == -1;
+
+  if (! failed)
+  {
+#ifdef __linux__
+    failed = (filesystem ? ::syncfs (fd) : ::fsync (fd)) == -1;
+#else
+    failed = ::fsync (fd) == -1;
+    if (filesystem)
+    {
+      ::sync ();
+    }
+#endif
+  }
+
+  auto error = errno;
+  if (fd != -1)
+  {
+    ::close (fd);
+  }
+
+  if (failed)
+  {
+    throw format ("Failed to sync '{1}': {2}", path, strerror (error));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string directory (const std::string& path)
+{
+  auto slash = path.rfind ('/');
+  if (slash == std::string::npos)
+  {
+    return ".";
+  }
+
+  return slash == 0 ? "/" : path.substr (0, slash);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Copies the content of the open file 'source' to 'target', starting from the
+// current offsets. Where the file system supports it, 'target' shares the data
+// blocks of 'source' and nothing is copied at all. Otherwise the kernel copies
+// the data, and only as a last resort is it copied through a buffer.
+static bool copyContent (int source, int target, off_t size, std::string& strategy)
+{
+#ifdef FICLONE
+  strategy = "clone";
+  if (::ioctl (target, FICLONE, source) == 0)
+  {
+    return true;
+  }
+#endif
+
+#ifdef __linux__
+  strategy = "copy_file_range";
+  off_t copied = 0;
+  while (copied < size)
+  {
+    auto count = ::copy_file_range (source, nullptr, target, nullptr, size - copied, 0);
+    if (count <= 0)
+    {
+      if (count == -1 && errno != EXDEV && errno != ENOSYS && errno != EOPNOTSUPP && errno != EINVAL)
+      {
+        return false;
+      }
+
+      break;
+    }
+
+    copied += count;
+  }
+
+  if (copied == size)
+  {
+    return true;
+  }
+#else
+  (void) size;
+#endif
+
+  strategy = "read/write";
+  char buffer[65536];
+  while (true)
+  {
+    auto count = ::read (source, buffer, sizeof (buffer));
+    if (count == 0)
+    {
+      return true;
+    }
+
+    if (count == -1)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      return false;
+    }
+
+    for (ssize_t written = 0; written < count; )
+    {
+      auto result = ::write (target, buffer + written, count - written);
+      if (result == -1 && errno != EINTR)
+      {
+        return false;
+      }
+
+      written += std::max (result, (ssize_t) 0);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Copies the file 'from' to the new file 'to', with the same permissions.
+// Returns the strategy used, see copyContent ().
+static std::string copyFile (const std::string& from, const std::string& to)
+{
+  int source = ::open (from.c_str (), O_RDONLY | O_CLOEXEC);
+  int target = -1;
+
+  struct stat s {};
+  if (source != -1 && ::fstat (source, &s) == 0)
+  {
+    target = ::open (to.c_str (), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, s.st_mode & 07777);
+  }
+
+  std::string strategy;
+  bool copied = target != -1 && copyContent (source, target, s.st_size, strategy);
+  auto error = errno;
+
+  if (source != -1)
+  {
+    ::close (source);
+  }
+
+  if (target != -1 && ::close (target) == -1 && copied)
+  {
+    copied = false;
+    error = errno;
+  }
+
+  if (! copied)
+  {
+    throw format ("Failed to copy '{1}' to '{2}': {3}", from, to, strerror (error));
+  }
+
+  return strategy;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 AtomicFile::impl::impl (const Path& path)
@@ -169,7 +353,7 @@ size_t AtomicFile::impl::size () const
   {
     throw format ("stat error {1}: {2}", errno, strerror (errno));
   }
-  return s.st_size;
+  return s.st_size + in_place_content.length ();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -177,6 +361,7 @@ void AtomicFile::impl::truncate ()
 {
   try 
   {
+    in_place_content.clear ();
     temp_file.truncate ();
     is_temp_active = true;
   }
@@ -192,6 +377,7 @@ void AtomicFile::impl::remove ()
 {
   try
   {
+    in_place_content.clear ();
     temp_file.remove ();
     is_temp_active = true;
   }
@@ -205,6 +391,7 @@ void AtomicFile::impl::remove ()
 ////////////////////////////////////////////////////////////////////////////////
 void AtomicFile::impl::read (std::string& content)
 {
+  materialize ();
   if (is_temp_active)
   {
     // Close the file before reading it in order to flush any buffers.
@@ -217,6 +404,7 @@ void AtomicFile::impl::read (std::string& content)
 ////////////////////////////////////////////////////////////////////////////////
 void AtomicFile::impl::read (std::vector <std::string>& lines)
 {
+  materialize ();
   if (is_temp_active)
   {
     // Close the file before reading it in order to flush any buffers.
@@ -231,14 +419,15 @@ void AtomicFile::impl::append (const std::string& content)
 {
   try
   {
+    materialize ();
     if (! is_temp_active)
     {
       is_temp_active = true;
 
-      if (real_file.exists () && ! File::copy (real_file, temp_file))
+      if (real_file.exists ())
       {
-        throw format ("Failed to copy '{1}' to '{2}'",
-                      real_file.name (), temp_file.name ());
+        auto strategy = copyFile (real_file._data, temp_file._data);
+        debug (format ("Copied '{1}' -> '{2}' using {3}", real_file._data, temp_file._data, strategy));
       }
     }
     return temp_file.append (content);
@@ -250,6 +439,34 @@ void AtomicFile::impl::append (const std::string& content)
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Appends without copying the file. The content is written to the end of the
+// real file on finalization, see finalize_in_place ().
+void AtomicFile::impl::append_in_place (const std::string& content)
+{
+  if (is_temp_active)
+  {
+    return append (content);
+  }
+
+  in_place_content += content;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Switches from appending in place to the temp file, for operations that need
+// the content.
+void AtomicFile::impl::materialize ()
+{
+  if (in_place_content.empty ())
+  {
+    return;
+  }
+
+  std::string content;
+  content.swap (in_place_content);
+  append (content);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void AtomicFile::impl::write_raw (const std::string& content)
 {
@@ -265,11 +482,49 @@ void AtomicFile::impl::write_raw (const std::string& content)
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Writes the lines, each followed by a newline, in blocks of about
+// WRITE_BUFFER_SIZE bytes rather than one write per line.
+void AtomicFile::impl::write_lines (const std::vector <std::string>& lines)
+{
+  try
+  {
+    std::string buffer;
+    buffer.reserve (WRITE_BUFFER_SIZE);
+
+    for (const auto& line : lines)
+    {
+      if (! buffer.empty () && buffer.size () + line.size () + 1 > WRITE_BUFFER_SIZE)
+      {
+        temp_file.write_raw (buffer);
+        buffer.clear ();
+      }
+
+      buffer += line;
+      buffer += '\n';
+    }
+
+    if (! buffer.empty ())
+    {
+      temp_file.write_raw (buffer);
+    }
+
+    is_temp_active = true;
+  }
+  catch (...)
+  {
+    allow_atomics = false;
+    throw;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void AtomicFile::impl::finalize ()
 {
   if (is_temp_active && impl::allow_atomics)
   {
+    changed_directories.insert (directory (real_file._data));
+
     if (temp_file.exists ())
     {
       debug (format ("Moving '{1}' -> '{2}'", temp_file._data, real_file._data));
@@ -288,6 +543,82 @@ void AtomicFile::impl::finalize ()
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Appends to the real file itself. Before the first byte is written, its
+// original size is recorded in a marker file next to it, which is removed
+// once the append is complete. Should the process die in between, rollback ()
+// finds the marker and truncates the file back to its original size. So, like
+// a renamed temp file, the append either happens completely or not at all.
+// Returns whether the appended content was synced to disk.
+bool AtomicFile::impl::finalize_in_place ()
+{
+  if (in_place_content.empty () || ! impl::allow_atomics)
+  {
+    return false;
+  }
+
+  changed_directories.insert (directory (real_file._data));
+
+  std::string marker = real_file._data + ".append";
+  std::string marker_temp = marker + ".tmp";
+
+  struct stat s;
+  off_t original = 0;
+  if (::stat (real_file._data.c_str (), &s) == 0)
+  {
+    original = s.st_size;
+  }
+  else if (errno != ENOENT)
+  {
+    throw format ("stat error {1}: {2}", errno, strerror (errno));
+  }
+
+  if (! File::write (marker_temp, std::to_string (original)) ||
+      std::rename (marker_temp.c_str (), marker.c_str ()))
+  {
+    std::remove (marker_temp.c_str ());
+    throw format ("Failed to prepare appending to '{1}'.", real_file._data);
+  }
+
+  debug (format ("Appending {1} bytes to '{2}'", in_place_content.length (), real_file._data));
+
+  int fd = ::open (real_file._data.c_str (), O_WRONLY | O_APPEND | O_CREAT, 0666);
+  bool failed = fd == -1;
+  for (std::string::size_type done = 0; ! failed && done < in_place_content.length (); )
+  {
+    auto count = ::write (fd, in_place_content.data () + done, in_place_content.length () - done);
+    if (count < 0 && errno == EINTR)
+    {
+      continue;
+    }
+
+    failed = count <= 0;
+    done += failed ? 0 : count;
+  }
+
+  if (! failed && durability == Durability::full && ::fsync (fd) == -1)
+  {
+    failed = true;
+  }
+
+  if (fd != -1 && ::close (fd) == -1)
+  {
+    failed = true;
+  }
+
+  if (failed)
+  {
+    auto error = errno;
+    rollback (real_file);
+    throw format ("Failed appending to '{1}': {2}. Database corruption possible.",
+                  real_file._data, strerror (error));
+  }
+
+  std::remove (marker.c_str ());
+  in_place_content.clear ();
+  return durability == Durability::full;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 AtomicFile::AtomicFile (const Path& path)
 {
@@ -395,12 +726,24 @@ void AtomicFile::append (const std::string& content)
   pimpl->append (content);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void AtomicFile::append_in_place (const std::string& content)
+{
+  pimpl->append_in_place (content);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void AtomicFile::write_raw (const std::string& content)
 {
   pimpl->write_raw (content);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void AtomicFile::write_lines (const std::vector <std::string>& lines)
+{
+  pimpl->write_lines (lines);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void AtomicFile::write (const Path& path, const std::string& data)
 {
@@ -414,10 +757,34 @@ void AtomicFile::write (const Path& path, const std::vector <std::string>& lines
 {
   AtomicFile file (path);
   file.truncate ();
-  for (const auto& line : lines)
+  file.write_lines (lines);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Undoes an interrupted append in place to the file, if its marker file
+// exists, by truncating the file back to the size recorded in the marker.
+void AtomicFile::rollback (const Path& path)
+{
+  std::string marker = path._data + ".append";
+
+  std::string content;
+  if (! File::read (marker, content))
+  {
+    return;
+  }
+
+  char* end = nullptr;
+  auto original = std::strtoll (content.c_str (), &end, 10);
+  if (end != content.c_str () && *end == '\0')
   {
-    file.append (line + '\n');
+    debug (format ("Rolling back '{1}' to {2} bytes", path._data, original));
+    if (::truncate (path._data.c_str (), original) == -1 && errno != ENOENT)
+    {
+      throw format ("Failed to roll back '{1}': {2}", path._data, strerror (errno));
+    }
   }
+
+  std::remove (marker.c_str ());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -448,20 +815,68 @@ void AtomicFile::finalize_all ()
     file->close ();
   }
 
+  // With full durability, the content of the temp files reaches the disk
+  // before they replace the real files.
+  auto started = std::chrono::steady_clock::now ();
+  std::chrono::steady_clock::duration syncing {};
+  int synced = 0;
+  if (durability == Durability::full)
+  {
+    for (auto& file : impl::atomic_files)
+    {
+      if (file->is_temp_active && file->temp_file.exists ())
+      {
+        sync (file->temp_file._data, false);
+        ++synced;
+      }
+    }
+
+    syncing = std::chrono::steady_clock::now () - started;
+  }
 
   sigset_t new_mask;
   sigset_t old_mask;
   sigfillset (&new_mask);
 
-  // Step 2: Rename the temp files to the *real* file
+  // Step 2: Complete the appends to the real files, then rename the temp files
+  // to the *real* files. A file describing appended content, such as the
+  // bounds of the undo journal segments, is thus never ahead of it.
   sigprocmask (SIG_SETMASK, &new_mask, &old_mask);
+  for (auto& file : impl::atomic_files)
+  {
+    if (file->finalize_in_place ())
+    {
+      ++synced;
+    }
+  }
+
   for (auto& file : impl::atomic_files)
   {
     file->finalize ();
   }
   sigprocmask (SIG_SETMASK, &old_mask, nullptr);
 
-  // Step 3: Cleanup any references
+  // Step 3: Make the renames durable, which with 'batch' also covers the
+  // content of the files.
+  if (durability != Durability::none && ! impl::changed_directories.empty ())
+  {
+    started = std::chrono::steady_clock::now ();
+    for (auto& changed : impl::changed_directories)
+    {
+      sync (changed, durability == Durability::batch);
+    }
+
+    syncing += std::chrono::steady_clock::now () - started;
+    debug (format ("Durability '{1}': synced {2} files and {3} directories in {4} ms",
+                   durability == Durability::batch ? "batch" : "full",
+                   synced,
+                   impl::changed_directories.size (),
+                   std::chrono::duration_cast <std::chrono::microseconds> (syncing).count () / 1000.0));
+  }
+
+  impl::changed_directories.clear ();
+
+  // Step 4: Cleanup any references
   impl::atomic_files_t new_atomic_files;
   for (auto& file : impl::atomic_files)
   {
@@ -480,5 +895,6 @@ void AtomicFile::finalize_all ()
 void AtomicFile::reset ()
 {
   impl::atomic_files.clear ();
+  impl::changed_directories.clear ();
   impl::allow_atomics = true;
 }
@@ -34,6 +34,10 @@ class Path;
 class AtomicFile
 {
 public:
+  // What finalize_all waits for to reach the disk, see 'durability'.
+  enum class Durability { none, batch, full };
+  static Durability durability;
+
   explicit AtomicFile (const Path& path);
   explicit AtomicFile (std::string path);
   AtomicFile (const AtomicFile&) = delete;
@@ -54,9 +58,12 @@ public:
   void read (std::string& content);
   void read (std::vector <std::string>& lines);
   void append (const std::string& content);
+  void append_in_place (const std::string& content);
   void write_raw (const std::string& content);
+  void write_lines (const std::vector <std::string>& lines);
 
   static void append (const Path& path, const std::string& data);
+  static void rollback (const Path& path);
 
   static void write (const Path& path, const std::string& data);
   static void write (const Path& path, const std::vector <std::string>& lines);
@@ -63,8 +63,8 @@ Chart::Chart (const ChartConfig& configuration) :
 std::string Chart::render (
   const Range& range,
   const std::vector <Interval>& tracked,
-  const std::vector <Range>& exclusions,
-  const std::map <Datetime, std::string>& holidays)
+  const RangeSet& exclusions,
+  const HolidayTable& holidays)
 {
   // Determine hours shown.
   auto hour_range = determine_hour_range
@@ -153,7 +153,7 @@ std::string Chart::render (
   }
 
   out << (with_totals ? renderSubTotal (total_work, std::string (padding_size, ' ')) : "")
-      << (with_holidays ? renderHolidays (holidays) : "")
+      << (with_holidays ? renderHolidays (range, holidays) : "")
       << (with_summary ? renderSummary (indent, range, exclusions, tracked) : "");
 
   return out.str ();
@@ -301,19 +301,16 @@ std::string Chart::renderDay (Datetime& day, const Color& color)
 ////////////////////////////////////////////////////////////////////////////////
 Color Chart::getDayColor (
   const Datetime& day,
-  const std::map <Datetime, std::string>& holidays)
+  const HolidayTable& holidays)
 {
   if (day.sameDay (reference_datetime))
   {
     return color_today;
   }
 
-  for (auto& entry : holidays)
+  if (holidays.contains (day))
   {
-    if (day.sameDay (entry.first))
-    {
-      return color_holiday;
-    }
+    return color_holiday;
   }
 
   return Color {};
@@ -370,7 +367,7 @@ void Chart::renderExclusionBlocks (
   const Datetime& day,
   int first_hour,
   int last_hour,
-  const std::vector <Range>& exclusions)
+  const RangeSet& exclusions)
 {
   // Render the exclusion blocks.
   for (int hour = first_hour; hour <= last_hour; hour++)
@@ -386,32 +383,33 @@ void Chart::renderExclusionBlocks (
       lines[0].add (label, offset, color_label);
     }
 
-    for (auto& exclusion : exclusions)
+    // The exclusions are sorted and disjoint, so only those from the first one
+    // ending after the start of the hour can overlap it.
+    for (auto exclusion = exclusions.lower_bound (hour_range.start);
+         exclusion != exclusions.end () && exclusion->start < hour_range.end;
+         ++exclusion)
     {
-      if (exclusion.overlaps (hour_range))
-      {
-        // Determine which of the character blocks included.
-        auto sub_hour = exclusion.intersect (hour_range);
-        auto start_block = quantizeToNMinutes (sub_hour.start.minute (), minutes_per_char) / minutes_per_char;
-        auto end_block = quantizeToNMinutes (sub_hour.end.minute () == 0 ? 60 : sub_hour.end.minute (), minutes_per_char) / minutes_per_char;
+      // Determine which of the character blocks included.
+      auto sub_hour = exclusion->intersect (hour_range);
+      auto start_block = quantizeToNMinutes (sub_hour.start.minute (), minutes_per_char) / minutes_per_char;
+      auto end_block = quantizeToNMinutes (sub_hour.end.minute () == 0 ? 60 : sub_hour.end.minute (), minutes_per_char) / minutes_per_char;
 
-        int offset = (hour - first_hour) * cell_width + start_block;
-        int width = end_block - start_block;
-        std::string block (width, ' ');
+      int offset = (hour - first_hour) * cell_width + start_block;
+      int width = end_block - start_block;
+      std::string block (width, ' ');
 
-        for (auto& line : lines)
-        {
-          line.add (block, offset, color_exclusion);
-        }
+      for (auto& line : lines)
+      {
+        line.add (block, offset, color_exclusion);
+      }
 
-        if (with_internal_axis)
+      if (with_internal_axis)
+      {
+        auto label = format ("{1}", hour);
+        if (start_block == 0 &&
+            width >= static_cast <int> (label.length ()))
         {
-          auto label = format ("{1}", hour);
-          if (start_block == 0 &&
-              width >= static_cast <int> (label.length ()))
-          {
-            lines[0].add (label, offset, color_exclusion);
-          }
+          lines[0].add (label, offset, color_exclusion);
         }
       }
     }
@@ -531,15 +529,22 @@ void Chart::renderInterval (
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-std::string Chart::renderHolidays (const std::map <Datetime, std::string>& holidays)
+// A day with holidays in several locales shows the one of the last locale.
+std::string Chart::renderHolidays (const Range& range, const HolidayTable& holidays)
 {
   std::stringstream out;
 
-  for (auto& entry : holidays)
+  auto entries = holidays.within (range);
+  for (auto entry = entries.begin (); entry != entries.end (); ++entry)
   {
-    out << entry.first.toString ("Y-M-D")
-        << " "
-        << entry.second
+    if (entry + 1 != entries.end () && (entry + 1)->date == entry->date)
+      continue;
+
+    out << entry->date.toString ("Y-M-D")
+        << "  ["
+        << entry->locale
+        << "] "
+        << entry->name
         << '\n';
   }
 
@@ -550,7 +555,7 @@ std::string Chart::renderHolidays (const std::map <Datetime, std::string>& holid
 std::string Chart::renderSummary (
   const std::string& indent,
   const Range& range,
-  const std::vector <Range>& exclusions,
+  const RangeSet& exclusions,
   const std::vector <Interval>& tracked)
 {
   std::stringstream out;
@@ -29,7 +29,9 @@
 
 #include <ChartConfig.h>
 #include <Composite.h>
+#include <HolidayTable.h>
 #include <Interval.h>
+#include <RangeSet.h>
 #include <map>
 
 class Chart
@@ -37,27 +39,27 @@ class Chart
 public:
   explicit Chart (const ChartConfig& configuration);
 
-  std::string render (const Range&, const std::vector <Interval>&, const std::vector <Range>&, const std::map <Datetime, std::string>&);
+  std::string render (const Range&, const std::vector <Interval>&, const RangeSet&, const HolidayTable&);
 
 private:
   std::string renderAxis (int, int);
   std::string renderDay (Datetime&, const Color&);
-  std::string renderHolidays (const std::map <Datetime, std::string>&);
+  std::string renderHolidays (const Range&, const HolidayTable&);
   std::string renderMonth (const Datetime&, const Datetime&);
   std::string renderSubTotal (time_t, const std::string&);
-  std::string renderSummary (const std::string&, const Range&, const std::vector <Range>&, const std::vector <Interval>&);
+  std::string renderSummary (const std::string&, const Range&, const RangeSet&, const std::vector <Interval>&);
   std::string renderTotal (time_t);
   std::string renderWeek (const Datetime&, const Datetime&);
   std::string renderWeekday (Datetime&, const Color&);
 
-  void renderExclusionBlocks (std::vector <Composite>&, const Datetime&, int, int, const std::vector <Range>&);
+  void renderExclusionBlocks (std::vector <Composite>&, const Datetime&, int, int, const RangeSet&);
   void renderInterval (std::vector <Composite>&, const Datetime&, const Interval&, int, time_t&);
 
   unsigned long getIndentSize ();
 
   std::pair <int, int> determineHourRange (const Range&, const std::vector <Interval>&);
 
-  Color getDayColor (const Datetime&, const std::map <Datetime, std::string>&);
+  Color getDayColor (const Datetime&, const HolidayTable&);
   Color getHourColor (int) const;
 
   const Datetime reference_datetime;
@@ -26,8 +26,10 @@
 
 #include <AtomicFile.h>
 #include <Database.h>
+#include <IntervalDelta.h>
 #include <IntervalFactory.h>
 #include <JSON.h>
+#include <algorithm>
 #include <cassert>
 #include <format.h>
 #include <iomanip>
@@ -102,14 +104,14 @@ bool Database::iterator::operator!= (const iterator& other) const
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-const std::string& Database::iterator::operator* () const
+const std::string_view& Database::iterator::operator* () const
 {
   assert (lines_it != lines_end);
   return *lines_it;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-const std::string* Database::iterator::operator-> () const
+const std::string_view* Database::iterator::operator-> () const
 {
   assert (lines_it != lines_end);
   return &(*lines_it);
@@ -123,8 +125,9 @@ Database::reverse_iterator::reverse_iterator (files_iterator fbegin,
 {
   if (files_end != files_it)
   {
-    lines_it = files_it->allLines ().begin ();
-    lines_end = files_it->allLines ().end ();
+    auto& lines = files_it->allLines ();
+    lines_it = lines.begin ();
+    lines_end = lines.end ();
     while ((lines_it == lines_end) && (files_it != files_end))
     {
       ++files_it;
@@ -155,8 +158,9 @@ Database::reverse_iterator& Database::reverse_iterator::operator++ ()
         ++files_it;
         if (files_it != files_end)
         {
-          lines_it = files_it->allLines ().begin ();
-          lines_end = files_it->allLines ().end ();
+          auto& lines = files_it->allLines ();
+          lines_it = lines.begin ();
+          lines_end = lines.end ();
         }
       }
     }
@@ -184,14 +188,14 @@ Database::reverse_iterator::operator!= (const reverse_iterator& other) const
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-const std::string& Database::reverse_iterator::operator* () const
+const std::string_view& Database::reverse_iterator::operator* () const
 {
   assert (lines_it != lines_end);
   return *lines_it;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-const std::string* Database::reverse_iterator::operator-> () const
+const std::string_view* Database::reverse_iterator::operator-> () const
 {
   return &operator* ();
 }
@@ -207,6 +211,62 @@ Database::iterator Database::begin ()
   return iterator (_files.rbegin (), _files.rend ());
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Range-seeking variant of begin (). Months that lie entirely after the range
+// cannot contain any interval intersecting it, so their data files are passed
+// over without being split or decoded. The number of lines skipped is returned
+// so that the caller can keep interval ids consistent.
+Database::iterator Database::begin (const Range& range, unsigned int& skipped)
+{
+  if (_files.empty ())
+  {
+    initializeDatafiles ();
+  }
+
+  skipped = 0;
+  auto files_it = _files.rbegin ();
+
+  if (range.is_ended ())
+  {
+    // A zero-width range [p, p) still matches an interval starting at p, so
+    // the month starting at p has to be kept in that case.
+    auto after_range = [&range] (const Datafile& file)
+    {
+      return range.end < file.range ().start ||
+             (range.end == file.range ().start && range.start != range.end);
+    };
+
+    while (files_it != _files.rend () && after_range (*files_it))
+    {
+      skipped += files_it->count ();
+      ++files_it;
+    }
+
+    // In the first month that is kept, the index tells how many of the most
+    // recent lines start after the range, without decoding them.
+    if (files_it != _files.rend ())
+    {
+      auto from = range.end;
+      if (range.start == range.end)
+      {
+        from = Datetime (from.toEpoch () + 1);
+      }
+
+      auto trailing = files_it->countFrom (from);
+      auto it = iterator (files_it, _files.rend ());
+      for (unsigned int i = 0; i < trailing; ++i)
+      {
+        ++it;
+      }
+
+      skipped += trailing;
+      return it;
+    }
+  }
+
+  return iterator (files_it, _files.rend ());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Database::iterator Database::end ()
 {
@@ -230,6 +290,31 @@ Database::reverse_iterator Database::rbegin ()
   return {_files.begin (), _files.end ()};
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Variant of rbegin () that starts after the given number of the oldest lines.
+// Data files holding only skipped lines are passed over without being split.
+Database::reverse_iterator Database::rbegin (unsigned int skip)
+{
+  if (_files.empty ())
+  {
+    initializeDatafiles ();
+  }
+
+  auto files_it = _files.begin ();
+  for (unsigned int lines; files_it != _files.end () && (lines = files_it->count ()) <= skip; ++files_it)
+  {
+    skip -= lines;
+  }
+
+  reverse_iterator it (files_it, _files.end ());
+  for (; skip > 0; --skip)
+  {
+    ++it;
+  }
+
+  return it;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Database::reverse_iterator Database::rend ()
 {
@@ -283,10 +368,18 @@ std::set <std::string> Database::tags () const
 
 ////////////////////////////////////////////////////////////////////////////////
 // Return most recent line from database 
+// Only the end of the data files is read, and not further back than the
+// newest file with any lines.
 std::string Database::getLatestEntry ()
 {
-  for (auto& line : *this)
+  if (_files.empty ())
+  {
+    initializeDatafiles ();
+  }
+
+  for (auto file = _files.rbegin (); file != _files.rend (); ++file)
   {
+    auto line = file->lastLine ();
     if (! line.empty ())
     {
       return line;
@@ -301,47 +394,42 @@ void Database::addInterval (const Interval& interval, bool verbose)
 {
   assert ((interval.end == 0) || (interval.start <= interval.end));
 
-  auto tags = interval.tags ();
-  for (auto& tag : tags)
-  {
-    if (_tagInfoDatabase.incrementTag (tag) == -1 && verbose)
-    {
-      std::cout << "Note: '" << quoteIfNeeded (tag) << "' is a new tag." << std::endl;
-    }
-  }
+  Batch batch (*this);
 
   // Get the index into _files for the appropriate Datafile, which may be
   // created on demand.
   auto df = getDatafile (interval.start.year (), interval.start.month ());
   _files[df].addInterval (interval);
-  _journal->recordIntervalAction ("", interval.json ());
+  batchAdd (interval, verbose);
+
+  batch.end ();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Database::deleteInterval (const Interval& interval)
 {
-  auto tags = interval.tags ();
-
-  for (auto& tag : tags)
-  {
-    _tagInfoDatabase.decrementTag (tag);
-  }
+  Batch batch (*this);
 
   // Get the index into _files for the appropriate Datafile, which may be
   // created on demand.
   auto df = getDatafile (interval.start.year (), interval.start.month ());
-
   _files[df].deleteInterval (interval);
-  _journal->recordIntervalAction (interval.json (), "");
+  batchRemove (interval);
+
+  batch.end ();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // The algorithm to modify an interval is first to find and remove it from the
 // Datafile, then add it back to the right Datafile. This is because
 // modification may involve changing the start date, which could mean the
-// Interval belongs in a different file.
+// Interval belongs in a different file. Both steps are one batch, so that an
+// interval keeping its start is recorded as a change rather than a removal and
+// an addition.
 void Database::modifyInterval (const Interval& from, const Interval& to, bool verbose)
 {
+  Batch batch (*this);
+
   if (! from.empty ())
   {
     deleteInterval (from);
@@ -351,6 +439,164 @@ void Database::modifyInterval (const Interval& from, const Interval& to, bool ve
   {
     addInterval (to, verbose);
   }
+
+  batch.end ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector <Interval> Database::intervalsStartingAt (const Datetime& start)
+{
+  auto df = getDatafile (start.year (), start.month ());
+  return _files[df].intervalsStartingAt (start);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Replace the intervals 'from' by the intervals 'to' as one batch. The edits
+// are grouped by month, so that each affected Datafile is modified in a single
+// pass.
+void Database::modifyIntervals (
+  const std::vector <Interval>& from,
+  const std::vector <Interval>& to,
+  bool verbose)
+{
+  std::map <std::pair <int, int>, std::pair <std::vector <Interval>, std::vector <Interval>>> edits;
+
+  for (auto& interval : from)
+  {
+    if (! interval.empty ())
+    {
+      edits[{interval.start.year (), interval.start.month ()}].first.push_back (interval);
+    }
+  }
+
+  for (auto& interval : to)
+  {
+    if (! interval.empty ())
+    {
+      assert ((interval.end == 0) || (interval.start <= interval.end));
+      edits[{interval.start.year (), interval.start.month ()}].second.push_back (interval);
+    }
+  }
+
+  for (auto& edit : edits)
+  {
+    auto df = getDatafile (edit.first.first, edit.first.second);
+    _files[df].modifyIntervals (edit.second.first, edit.second.second);
+  }
+
+  Batch batch (*this);
+
+  for (auto& edit : edits)
+  {
+    for (auto& interval : edit.second.first)
+    {
+      batchRemove (interval);
+    }
+  }
+
+  for (auto& edit : edits)
+  {
+    for (auto& interval : edit.second.second)
+    {
+      batchAdd (interval, verbose);
+    }
+  }
+
+  batch.end ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Start collecting tag count changes and undo actions, until endBatch.
+void Database::startBatch ()
+{
+  if (_batching)
+  {
+    throw std::string ("Subsequent call to start batch");
+  }
+
+  _batching = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Apply the net tag count changes of the batch, and record the batch as a
+// single undo action holding the delta between the removed and the added
+// intervals.
+void Database::endBatch ()
+{
+  if (! _batching)
+  {
+    throw std::string ("Call to end non-existent batch");
+  }
+
+  for (auto& tag : _batchTags)
+  {
+    for (int count = tag.second; count > 0; --count)
+    {
+      if (_tagInfoDatabase.incrementTag (tag.first) == -1 && _batchVerbose)
+      {
+        std::cout << "Note: '" << quoteIfNeeded (tag.first) << "' is a new tag." << std::endl;
+      }
+    }
+
+    for (int count = tag.second; count < 0; ++count)
+    {
+      _tagInfoDatabase.decrementTag (tag.first);
+    }
+  }
+
+  if (_journal->enabled ())
+  {
+    auto entries = IntervalDelta::encode (_batchRemoved, _batchAdded);
+    if (! entries.empty ())
+    {
+      _journal->recordDeltaAction (entries);
+    }
+  }
+
+  abandonBatch ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Drop the collected changes of the batch. The Datafiles keep their edits, but
+// as they are only written by commit, which is not reached after an error,
+// nothing of the batch is persisted.
+void Database::abandonBatch ()
+{
+  _batching = false;
+  _batchVerbose = false;
+  _batchTags.clear ();
+  _batchRemoved.clear ();
+  _batchAdded.clear ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Database::Batch::Batch (Database& database)
+: _database (database)
+, _active (! database._batching)
+{
+  if (_active)
+  {
+    _database.startBatch ();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Database::Batch::~Batch ()
+{
+  if (_active)
+  {
+    _database.abandonBatch ();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Database::Batch::end ()
+{
+  if (_active)
+  {
+    _database.endBatch ();
+    _active = false;
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -366,6 +612,47 @@ std::string Database::dump () const
   return out.str ();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void Database::batchTags (const Interval& interval, int delta)
+{
+  for (auto& id : interval.tagIds ())
+  {
+    _batchTags[TagDictionary::name (id)] += delta;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Database::batchAdd (const Interval& interval, bool verbose)
+{
+  batchTags (interval, 1);
+  _batchAdded.push_back (interval);
+  _batchVerbose = _batchVerbose || verbose;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// An interval that was added earlier in the same batch is no longer part of
+// the undo record once it is removed again, as undo could not remove it.
+void Database::batchRemove (const Interval& interval)
+{
+  batchTags (interval, -1);
+
+  auto added = std::find_if (_batchAdded.rbegin (), _batchAdded.rend (), [&interval] (const Interval& other)
+  {
+    return other.Range::operator== (interval) &&
+           other.tagIds () == interval.tagIds () &&
+           other.annotation == interval.annotation;
+  });
+
+  if (added != _batchAdded.rend ())
+  {
+    _batchAdded.erase (std::next (added).base ());
+  }
+  else
+  {
+    _batchRemoved.push_back (interval);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 unsigned int Database::getDatafile (int year, int month)
 {
@@ -398,62 +685,22 @@ unsigned int Database::getDatafile (int year, int month)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// The input Daterange has a start and end, for example:
-//
-//   2016-02-20 to 2016-04-15
-//
-// Given the monthly storage scheme, split the Daterange into a vector of
-// segmented Dateranges:
-//
-//   2016-02-01 to 2016-03-01
-//   2016-03-01 to 2016-04-01
-//   2016-04-01 to 2016-05-01
-//
-std::vector <Range> Database::segmentRange (const Range& range)
+// Number of lines in all data files. Uses the indexes where available, so the
+// files need not be read.
+unsigned int Database::count ()
 {
-  std::vector <Range> segments;
-
-  auto start_y = range.start.year ();
-  auto start_m = range.start.month ();
-
-  auto end = range.end;
-  if (end.toEpoch () == 0)
+  if (_files.empty ())
   {
-    end = Datetime ();
+    initializeDatafiles ();
   }
 
-  auto end_y = end.year ();
-  auto end_m = end.month ();
-
-  while (start_y < end_y ||
-         (start_y == end_y && start_m <= end_m))
+  unsigned int lines = 0;
+  for (auto& file : _files)
   {
-    // Capture date before incrementing month.
-    Datetime segmentStart (start_y, start_m, 1);
-
-    // Next month.
-    start_m += 1;
-    if (start_m > 12)
-    {
-      start_y += 1;
-      start_m = 1;
-    }
-
-    // Capture date after incrementing month.
-    Datetime segmentEnd (start_y, start_m, 1);
-    auto segment = Range (segmentStart, segmentEnd);
-    if (range.intersects (segment))
-    {
-      segments.push_back (segment);
-    }
+    lines += file.count ();
   }
 
-  return segments;
-}
-
-bool Database::empty ()
-{
-  return Database::begin () == Database::end ();
+  return lines;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -525,9 +772,9 @@ void Database::initializeTagDatabase ()
   for (; it != end; ++it)
   {
     Interval interval = IntervalFactory::fromSerialization (*it);
-    for (auto& tag : interval.tags ())
+    for (auto id : interval.tagIds ())
     {
-      _tagInfoDatabase.incrementTag (tag);
+      _tagInfoDatabase.incrementTag (TagDictionary::name (id));
     }
   }
 }
@@ -541,6 +788,16 @@ void Database::initializeDatafiles ()
   auto files = d.list ();
   std::sort (files.begin (), files.end ());
 
+  for (auto& file : files)
+  {
+    // Undo appends that were interrupted, before any file is read.
+    if (file.length () > 7 &&
+        file.find (".append") == file.length () - 7)
+    {
+      AtomicFile::rollback (Path (file.substr (0, file.length () - 7)));
+    }
+  }
+
   for (auto& file : files)
   {
     // If it looks like a data file: *-??.data
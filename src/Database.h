@@ -33,7 +33,9 @@
 #include <Range.h>
 #include <TagInfoDatabase.h>
 #include <Transaction.h>
+#include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Database
@@ -45,8 +47,8 @@ public:
   private:
     friend class Database;
     typedef std::vector <Datafile>::reverse_iterator files_iterator;
-    typedef std::vector <std::string>::const_reverse_iterator lines_iterator;
-    typedef std::string value_type;
+    typedef std::vector <std::string_view>::const_reverse_iterator lines_iterator;
+    typedef std::string_view value_type;
 
     files_iterator files_it;
     files_iterator files_end;
@@ -71,8 +73,8 @@ public:
   private:
     friend class Database;
     typedef std::vector <Datafile>::iterator files_iterator;
-    typedef std::vector <std::string>::const_iterator lines_iterator;
-    typedef std::string value_type;
+    typedef std::vector <std::string_view>::const_iterator lines_iterator;
+    typedef std::string_view value_type;
 
     files_iterator files_it;
     files_iterator files_end;
@@ -92,6 +94,21 @@ public:
     const value_type* operator-> () const;
   };
 
+  // Starts a batch unless one is already running, and ends it on end (). A
+  // batch left by an exception is abandoned instead, so neither tag counts
+  // nor an undo action are recorded for it.
+  class Batch
+  {
+  public:
+    explicit Batch (Database&);
+    ~Batch ();
+    void end ();
+
+  private:
+    Database& _database;
+    bool _active;
+  };
+
 public:
   Database () = default;
   void initialize (const std::string&, Journal& journal);
@@ -104,26 +121,44 @@ public:
   void addInterval (const Interval&, bool verbose);
   void deleteInterval (const Interval&);
   void modifyInterval (const Interval&, const Interval&, bool verbose);
+  void modifyIntervals (const std::vector <Interval>&, const std::vector <Interval>&, bool verbose);
+  std::vector <Interval> intervalsStartingAt (const Datetime&);
 
   std::string dump () const;
 
   bool empty ();
+  unsigned int count ();
   iterator begin ();
+  iterator begin (const Range&, unsigned int&);
   iterator end ();
   reverse_iterator rbegin ();
+  reverse_iterator rbegin (unsigned int);
   reverse_iterator rend ();
 
 private:
   unsigned int getDatafile (int, int);
-  std::vector <Range> segmentRange (const Range&);
   void initializeDatafiles ();
   void initializeTagDatabase ();
+  void startBatch ();
+  void endBatch ();
+  void abandonBatch ();
+  void batchTags (const Interval&, int);
+  void batchAdd (const Interval&, bool);
+  void batchRemove (const Interval&);
 
 private:
   std::string               _location {};
   std::vector <Datafile>    _files    {};
   TagInfoDatabase           _tagInfoDatabase {};
   Journal*                  _journal {};
+
+  // Changes within a batch are applied to the Datafiles right away, while the
+  // tag counts and the undo record are updated once, at the end of the batch.
+  bool                      _batching {false};
+  bool                      _batchVerbose {false};
+  std::map <std::string, int> _batchTags {};
+  std::vector <Interval>    _batchRemoved {};
+  std::vector <Interval>    _batchAdded {};
 };
 
 #endif
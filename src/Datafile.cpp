@@ -27,17 +27,108 @@
 #include <AtomicFile.h>
 #include <Datafile.h>
 #include <IntervalFactory.h>
+#include <IsoTimestamp.h>
 #include <algorithm>
 #include <cassert>
+#include <cerrno>
 #include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
 #include <format.h>
 #include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <timew.h>
+#include <unistd.h>
+
+#ifdef NDEBUG
+Datafile::Verification Datafile::verification {Datafile::Verification::off};
+#else
+Datafile::Verification Datafile::verification {Datafile::Verification::always};
+#endif
+
+static const unsigned int SAMPLE_INTERVAL = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+// Read-only view of the contents of a data file. The file is memory mapped,
+// so reading it neither copies nor allocates per line. The mapping is shared
+// between copies of a Datafile and released with the last of them.
+struct Datafile::Mapping
+{
+  explicit Mapping (const Path&);
+  Mapping (const Mapping&) = delete;
+  Mapping& operator= (const Mapping&) = delete;
+  ~Mapping ();
+
+  std::string_view content () const;
+
+  void*  data {MAP_FAILED};
+  size_t size {0};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+Datafile::Mapping::Mapping (const Path& path)
+{
+  int fd = ::open (path._data.c_str (), O_RDONLY);
+  if (fd == -1)
+  {
+    if (errno == ENOENT)
+    {
+      return;
+    }
+
+    throw format ("Could not read data file {1}: {2}", path._data, strerror (errno));
+  }
+
+  struct stat s;
+  if (::fstat (fd, &s) == -1)
+  {
+    auto error = errno;
+    ::close (fd);
+    throw format ("Could not read data file {1}: {2}", path._data, strerror (error));
+  }
+
+  // An empty file cannot be mapped, but has no lines anyway.
+  size = s.st_size;
+  if (size > 0)
+  {
+    data = ::mmap (nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+    {
+      auto error = errno;
+      ::close (fd);
+      throw format ("Could not map data file {1}: {2}", path._data, strerror (error));
+    }
+  }
+
+  ::close (fd);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Datafile::Mapping::~Mapping ()
+{
+  if (data != MAP_FAILED)
+  {
+    ::munmap (data, size);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string_view Datafile::Mapping::content () const
+{
+  if (data == MAP_FAILED)
+  {
+    return {};
+  }
+
+  return {static_cast <const char*> (data), size};
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 void Datafile::initialize (const std::string& name)
 {
   _file = Path (name);
+  _index_file = Path (name.substr (0, name.length () - 5) + ".idx");
 
   // From the name, which is of the form YYYY-MM.data, extract the YYYY and MM.
   auto basename = _file.name ();
@@ -63,43 +154,160 @@ std::string Datafile::name () const
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Identifies the last incluѕion (^i) lines
+const Range& Datafile::range () const
+{
+  return _range;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reads the last non-empty line of a file without reading the whole file. The
+// file is read backwards from its end, one block at a time, until the start of
+// that line is found.
+static std::string readLastLine (const Path& path)
+{
+  int fd = ::open (path._data.c_str (), O_RDONLY);
+  if (fd == -1)
+  {
+    if (errno == ENOENT)
+    {
+      return "";
+    }
+
+    throw format ("Could not read data file {1}: {2}", path._data, strerror (errno));
+  }
+
+  struct stat s;
+  if (::fstat (fd, &s) == -1)
+  {
+    auto error = errno;
+    ::close (fd);
+    throw format ("Could not read data file {1}: {2}", path._data, strerror (error));
+  }
+
+  const off_t block_size = 4096;
+  std::string tail;
+  off_t offset = s.st_size;
+  while (offset > 0)
+  {
+    auto size = std::min (block_size, offset);
+    offset -= size;
+
+    std::string block (size, '\0');
+    for (off_t done = 0; done < size; )
+    {
+      auto count = ::pread (fd, &block[done], size - done, offset + done);
+      if (count <= 0)
+      {
+        auto error = count == 0 ? EIO : errno;
+        if (error == EINTR)
+          continue;
+
+        ::close (fd);
+        throw format ("Could not read data file {1}: {2}", path._data, strerror (error));
+      }
+
+      done += count;
+    }
+
+    tail.insert (0, block);
+
+    auto last = tail.find_last_not_of ('\n');
+    if (last != std::string::npos)
+    {
+      auto eol = tail.rfind ('\n', last);
+      if (eol != std::string::npos)
+      {
+        ::close (fd);
+        return tail.substr (eol + 1, last - eol);
+      }
+    }
+  }
+
+  ::close (fd);
+
+  auto last = tail.find_last_not_of ('\n');
+  return last == std::string::npos ? "" : tail.substr (0, last + 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The last non-empty line. Unless the lines are already loaded, only the end
+// of the file is read.
 std::string Datafile::lastLine ()
 {
   if (! _lines_loaded)
-    load_lines ();
+  {
+    return readLastLine (_file);
+  }
 
-  std::vector <std::string>::reverse_iterator ri;
-  for (ri = _lines.rbegin (); ri != _lines.rend (); ri++)
-    if (ri->operator[] (0) == 'i')
-      return *ri;
+  for (auto ri = allLines ().rbegin (); ri != _views.rend (); ri++)
+    if (! ri->empty ())
+      return std::string (*ri);
 
   return "";
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-const std::vector <std::string>& Datafile::allLines ()
+// The lines are views into either the mapped file or, once the file has been
+// modified, the owned lines. The views of owned lines are recreated on every
+// call, as they do not survive copying or modifying the Datafile.
+const std::vector <std::string_view>& Datafile::allLines ()
 {
   if (! _lines_loaded)
     load_lines ();
 
-  return _lines;
+  if (_lines_owned)
+    _views.assign (_lines.begin (), _lines.end ());
+
+  return _views;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Accepted intervals;   day1 <= interval.start < dayN
-void Datafile::addInterval (const Interval& interval)
+// Number of lines in the file. If the lines are not loaded yet, they are only
+// counted, not split.
+unsigned int Datafile::count ()
 {
-  // Note: end date might be zero.
-  assert (interval.startsWithin (_range));
+  if (_lines_loaded)
+    return _lines_owned ? _lines.size () : _views.size ();
 
-  if (! _lines_loaded)
-    load_lines ();
+  if (load_index ())
+    return _index.size ();
+
+  Mapping mapping (_file);
+  auto content = mapping.content ();
+  unsigned int lines = std::count (content.begin (), content.end (), '\n');
+  if (! content.empty () && content.back () != '\n')
+    ++lines;
 
+  return lines;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Number of trailing lines whose intervals are known to start at or after the
+// given time. This relies on the index, so without one nothing is known and 0
+// is returned.
+unsigned int Datafile::countFrom (const Datetime& start)
+{
+  if (_dirty || ! load_index ())
+    return 0;
+
+  return _index.size () - _index.lowerBound (start.toEpoch ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Ensure that the IntervalFactory can properly parse the serialization before
+// adding it to the database. When sampling, the first interval and every
+// SAMPLE_INTERVAL-th after it are checked.
+static std::string checkedSerialization (const Interval& interval)
+{
   const std::string serialization = interval.serialize ();
 
-  // Ensure that the IntervalFactory can properly parse the serialization before
-  // adding it to the database.
+  static unsigned int written = 0;
+  if (Datafile::verification == Datafile::Verification::off ||
+      (Datafile::verification == Datafile::Verification::sample && written++ % SAMPLE_INTERVAL != 0))
+  {
+    return serialization;
+  }
+
   try
   {
     Interval test = IntervalFactory::fromSerialization (serialization);
@@ -109,62 +317,199 @@ void Datafile::addInterval (const Interval& interval)
       throw (format ("Encode / decode check failed:\n  {1}\nis not equal to:\n  {2}",
                      interval.dump (), test.dump ()));
     }
-
-    _lines.push_back (serialization);
-    debug (format ("{1}: Added {2}", _file.name (), _lines.back ()));
-    _dirty = true;
   }
   catch (const std::string& error)
   {
     debug (format ("Datafile::addInterval() failed.\n{1}", error));
     throw std::string ("Internal error. Failed encode / decode check.");
   }
+
+  return serialization;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void Datafile::deleteInterval (const Interval& interval)
+// Callers are about to modify the file, so the lines are owned, and sorted.
+std::vector <Interval> Datafile::intervalsStartingAt (const Datetime& start)
+{
+  own_lines ();
+
+  auto key = "inc " + IsoTimestamp::encode (start.toEpoch ());
+  std::vector <Interval> intervals;
+  for (auto line = std::lower_bound (_lines.begin (), _lines.end (), key);
+       line != _lines.end () && ! line->compare (0, key.size (), key);
+       ++line)
+  {
+    if (line->size () == key.size () || (*line)[key.size ()] == ' ')
+    {
+      intervals.push_back (IntervalFactory::fromSerialization (*line));
+    }
+  }
+
+  return intervals;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Accepted intervals;   day1 <= interval.start < dayN
+void Datafile::addInterval (const Interval& interval)
 {
   // Note: end date might be zero.
   assert (interval.startsWithin (_range));
 
-  if (! _lines_loaded)
+  own_lines ();
+
+  const std::string serialization = checkedSerialization (interval);
+
+  // A line sorting before the current last one means the file must be
+  // rewritten in order.
+  auto position = std::upper_bound (_lines.begin (), _lines.end (), serialization);
+  if (position != _lines.end ())
   {
-    load_lines ();
+    _appends_only = false;
   }
 
+  _lines.insert (position, serialization);
+  debug (format ("{1}: Added {2}", _file.name (), serialization));
+  _dirty = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Datafile::deleteInterval (const Interval& interval)
+{
+  // Note: end date might be zero.
+  assert (interval.startsWithin (_range));
+
+  own_lines ();
+
   auto serialized = interval.serialize ();
-  auto i = std::find (_lines.begin (), _lines.end (), serialized);
-  if (i == _lines.end ())
+  auto i = std::lower_bound (_lines.begin (), _lines.end (), serialized);
+  if (i == _lines.end () || *i != serialized)
   {
     throw format ("Datafile::deleteInterval failed to find '{1}'", serialized);
   }
 
   _lines.erase (i);
+  _appends_only = false;
   _dirty = true;
   debug (format ("{1}: Deleted {2}", _file.name (), serialized));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Delete the removed intervals and add the added ones in a single pass over
+// the lines, instead of shifting them once per interval. Nothing is modified
+// unless all removed intervals are found.
+void Datafile::modifyIntervals (
+  const std::vector <Interval>& removed,
+  const std::vector <Interval>& added)
+{
+  own_lines ();
+
+  std::vector <std::string> deletions;
+  deletions.reserve (removed.size ());
+  for (auto& interval : removed)
+  {
+    assert (interval.startsWithin (_range));
+    deletions.push_back (interval.serialize ());
+  }
+
+  std::vector <std::string> additions;
+  additions.reserve (added.size ());
+  for (auto& interval : added)
+  {
+    assert (interval.startsWithin (_range));
+    additions.push_back (checkedSerialization (interval));
+  }
+
+  std::sort (deletions.begin (), deletions.end ());
+  std::sort (additions.begin (), additions.end ());
+
+  if (! std::includes (_lines.begin (), _lines.end (), deletions.begin (), deletions.end ()))
+  {
+    for (auto& serialized : deletions)
+    {
+      if (! std::binary_search (_lines.begin (), _lines.end (), serialized))
+      {
+        throw format ("Datafile::deleteInterval failed to find '{1}'", serialized);
+      }
+    }
+
+    throw format ("Datafile::deleteInterval failed to find '{1}'", deletions.back ());
+  }
+
+  if (! deletions.empty ())
+  {
+    auto deletion = deletions.begin ();
+    auto kept = _lines.begin ();
+    for (auto line = _lines.begin (); line != _lines.end (); ++line)
+    {
+      if (deletion != deletions.end () && *deletion == *line)
+      {
+        debug (format ("{1}: Deleted {2}", _file.name (), *deletion));
+        ++deletion;
+      }
+      else
+      {
+        if (kept != line)
+        {
+          *kept = std::move (*line);
+        }
+
+        ++kept;
+      }
+    }
+
+    _lines.erase (kept, _lines.end ());
+    _appends_only = false;
+    _dirty = true;
+  }
+
+  if (! additions.empty ())
+  {
+    if (! _lines.empty () && additions.front () < _lines.back ())
+    {
+      _appends_only = false;
+    }
+
+    auto middle = _lines.size ();
+    for (auto& serialization : additions)
+    {
+      debug (format ("{1}: Added {2}", _file.name (), serialization));
+      _lines.push_back (std::move (serialization));
+    }
+
+    std::inplace_merge (_lines.begin (), _lines.begin () + middle, _lines.end ());
+    _dirty = true;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void Datafile::commit ()
 {
   // The _dirty flag indicates that the file needs to be written.
-  if (_dirty)
+  if (_dirty && ! commit_appended ())
   {
     AtomicFile file (_file);
     if (! _lines.empty ())
     {
       if (file.open ())
       {
-        // Sort the intervals by ascending start time.
-        std::sort (_lines.begin (), _lines.end ());
-
-        // Write out all the lines.
+        // Write out all the lines, which are kept sorted.
         file.truncate ();
-        for (auto& line : _lines)
+        file.write_lines (_lines);
+
+        // Keep the index in step with the lines just written.
+        _index.build (allLines ());
+        _index_loaded = true;
+        if (_index.valid ())
+        {
+          AtomicFile::write (_index_file, _index.serialize ());
+        }
+        else
         {
-          file.write_raw (line + '\n');
+          AtomicFile (_index_file).remove ();
         }
 
+        _persisted = _lines.size ();
+        _appends_only = true;
         _dirty = false;
       }
       else
@@ -175,10 +520,66 @@ void Datafile::commit ()
     else
     {
       file.remove ();
+      AtomicFile (_index_file).remove ();
+      _index.clear ();
+      _index_loaded = true;
+      _persisted = 0;
+      _appends_only = true;
+      _dirty = false;
     }
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// If the only changes since the file was read or written are lines added after
+// the existing ones, commits them by appending to the file and its index,
+// instead of rewriting both. Returns false if the file needs a rewrite.
+bool Datafile::commit_appended ()
+{
+  if (! _appends_only ||
+      _lines.size () <= _persisted)
+  {
+    return false;
+  }
+
+  // The index must describe the file as it is now, before the append.
+  std::string records;
+  std::vector <std::string_view> appended (_lines.begin () + _persisted, _lines.end ());
+  bool index_appended = load_index () && _index.size () == _persisted && _index.append (appended, records);
+
+  std::string content;
+  for (auto& line : appended)
+  {
+    content += line;
+    content += '\n';
+  }
+
+  AtomicFile (_file).append_in_place (content);
+  debug (format ("{1}: Appending {2} lines", _file.name (), appended.size ()));
+
+  if (index_appended)
+  {
+    AtomicFile (_index_file).append_in_place (records);
+  }
+  else
+  {
+    _index.build (allLines ());
+    _index_loaded = true;
+    if (_index.valid ())
+    {
+      AtomicFile::write (_index_file, _index.serialize ());
+    }
+    else
+    {
+      AtomicFile (_index_file).remove ();
+    }
+  }
+
+  _persisted = _lines.size ();
+  _dirty = false;
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::string Datafile::dump () const
 {
@@ -186,8 +587,10 @@ std::string Datafile::dump () const
   out << "Datafile\n"
       << "  Name:        " << _file.name () << (_file.exists () ? "" : " (does not exist)") << '\n'
       << "  dirty:       " << (_dirty ? "true" : "false") << '\n'
-      << "  lines:       " << _lines.size () << '\n'
+      << "  lines:       " << (_lines_owned ? _lines.size () : _views.size ()) << '\n'
       << "    loaded     " << (_lines_loaded ? "true" : "false") << '\n'
+      << "    owned      " << (_lines_owned ? "true" : "false") << '\n'
+      << "  index:       " << (_index.valid () ? "valid" : "none") << '\n'
       << "  range:       " << _range.start.toISO () << " - "
                            << _range.end.toISO () << '\n';
 
@@ -195,23 +598,75 @@ std::string Datafile::dump () const
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// Maps the file and splits it into views, one per line. A missing file has no
+// lines.
 void Datafile::load_lines ()
 {
-  AtomicFile file (_file);
-  if (file.open ())
+  _mapping = std::make_shared <Mapping> (_file);
+  auto content = _mapping->content ();
+
+  _views.clear ();
+  std::string_view::size_type start = 0;
+  while (start < content.length ())
   {
-    // Load the data.
-    std::vector <std::string> read_lines;
-    file.read (read_lines);
-    file.close ();
+    auto eol = content.find ('\n', start);
+    if (eol == std::string_view::npos)
+    {
+      eol = content.length ();
+    }
+
+    _views.push_back (content.substr (start, eol - start));
+    start = eol + 1;
+  }
 
-    // Append the lines that were read.
-    for (auto& line : read_lines)
-      _lines.push_back (line);
+  _lines_loaded = true;
+  debug (format ("{1}: {2} intervals", _file.name (), _views.size ()));
+}
 
-    _lines_loaded = true;
-    debug (format ("{1}: {2} intervals", file.name (), read_lines.size ()));
+////////////////////////////////////////////////////////////////////////////////
+// Copies the lines out of the mapped file before they are modified. Months
+// that are only read never get here.
+void Datafile::own_lines ()
+{
+  if (! _lines_loaded)
+    load_lines ();
+
+  if (! _lines_owned)
+  {
+    // Appending is only possible to a file ending in a complete line.
+    auto content = _mapping->content ();
+    if (! content.empty () && content.back () != '\n')
+    {
+      _appends_only = false;
+    }
+
+    _lines.assign (_views.begin (), _views.end ());
+    _persisted = _lines.size ();
+    _lines_owned = true;
+    _mapping.reset ();
+
+    // Serialized lines begin with the start time, so keeping them sorted
+    // orders them by start and lets add and delete use a binary search. A
+    // file that is out of order, perhaps edited by hand, gets rewritten.
+    if (! std::is_sorted (_lines.begin (), _lines.end ()))
+    {
+      std::sort (_lines.begin (), _lines.end ());
+      _appends_only = false;
+    }
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// Loads the index on first use. Returns whether a valid index is available.
+bool Datafile::load_index ()
+{
+  if (! _index_loaded)
+  {
+    _index.load (_index_file, _file);
+    _index_loaded = true;
+  }
+
+  return _index.valid ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
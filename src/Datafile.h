@@ -27,37 +27,63 @@
 #ifndef INCLUDED_DATAFILE
 #define INCLUDED_DATAFILE
 
+#include <DatafileIndex.h>
 #include <FS.h>
 #include <Interval.h>
 #include <Range.h>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class Datafile
 {
 public:
+  // How often an added interval is decoded again and compared, see
+  // 'debug.serialization'.
+  enum class Verification { off, sample, always };
+  static Verification verification;
+
   Datafile () = default;
   void initialize (const std::string&);
   std::string name () const;
+  const Range& range () const;
 
   std::string lastLine ();
-  const std::vector <std::string>& allLines ();
+  const std::vector <std::string_view>& allLines ();
+  unsigned int count ();
+  unsigned int countFrom (const Datetime&);
+  std::vector <Interval> intervalsStartingAt (const Datetime&);
 
   void addInterval (const Interval&);
   void deleteInterval (const Interval&);
+  void modifyIntervals (const std::vector <Interval>&, const std::vector <Interval>&);
   void commit ();
 
   std::string dump () const;
 
 private:
+  struct Mapping;
+
   void load_lines ();
+  void own_lines ();
+  bool load_index ();
+  bool commit_appended ();
 
 private:
-  Path                      _file         {};
-  bool                      _dirty        {false};
-  std::vector <std::string> _lines        {};
-  bool                      _lines_loaded {false};
-  Range                     _range        {};
+  Path                           _file         {};
+  Path                           _index_file   {};
+  DatafileIndex                  _index        {};
+  bool                           _index_loaded {false};
+  bool                           _dirty        {false};
+  std::shared_ptr <Mapping>      _mapping      {};
+  std::vector <std::string_view> _views        {};
+  std::vector <std::string>      _lines        {};
+  bool                           _lines_owned  {false};
+  bool                           _lines_loaded {false};
+  unsigned int                   _persisted    {0};
+  bool                           _appends_only {true};
+  Range                          _range        {};
 };
 
 #endif
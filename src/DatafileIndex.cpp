@@ -0,0 +1,261 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <DatafileIndex.h>
+#include <IsoTimestamp.h>
+#include <algorithm>
+#include <sstream>
+
+// After a header line with the format version, every record is a line of
+// two fixed-width hexadecimal fields:
+//
+//   <start> <length>\n
+//
+// which keeps the file plain text while still allowing a record to be found
+// by its position alone. The size of the data file it describes follows from
+// the line lengths, so lines appended to the data file only need records
+// appended to the index.
+static const std::string INDEX_MAGIC   = "timew-index";
+static const int         INDEX_VERSION = 3;
+static const int         FIELD_WIDTH   = 8;
+static const int         RECORD_WIDTH  = 2 * (FIELD_WIDTH + 1);
+
+////////////////////////////////////////////////////////////////////////////////
+static void appendHex (std::string& out, uint32_t value, char separator)
+{
+  static const char digits[] = "0123456789abcdef";
+
+  for (int shift = (FIELD_WIDTH - 1) * 4; shift >= 0; shift -= 4)
+  {
+    out += digits[(value >> shift) & 0xf];
+  }
+
+  out += separator;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void appendRecord (std::string& out, const DatafileIndex::Entry& entry)
+{
+  appendHex (out, entry.start, ' ');
+  appendHex (out, entry.length, '\n');
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static bool parseHex (const std::string& in, std::string::size_type offset, uint32_t& value)
+{
+  value = 0;
+  for (int i = 0; i < FIELD_WIDTH; ++i)
+  {
+    auto c = in[offset + i];
+    value <<= 4;
+
+    if (c >= '0' && c <= '9')
+      value |= c - '0';
+    else if (c >= 'a' && c <= 'f')
+      value |= c - 'a' + 10;
+    else
+      return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Creates the index for the given lines, which are expected to be exactly
+// those that are written to the data file. A line without a start time, or
+// that starts before the line preceding it, leaves the index invalid.
+void DatafileIndex::build (const std::vector <std::string_view>& lines)
+{
+  clear ();
+  _valid = true;
+
+  std::string records;
+  append (lines, records);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Adds entries for lines appended to the data file, and returns the records
+// to append to the index file. A line without a start time, or one that is
+// out of order, leaves the index invalid, and false is returned.
+bool DatafileIndex::append (const std::vector <std::string_view>& lines, std::string& records)
+{
+  if (! _valid)
+  {
+    return false;
+  }
+
+  auto first = _entries.size ();
+  uint32_t size = _data_size;
+  for (auto& line : lines)
+  {
+    // Only the start is needed, which follows 'inc ' in every line.
+    Entry entry;
+    if (line.compare (0, 4, "inc ") != 0 ||
+        ! IsoTimestamp::decode (line.substr (4, IsoTimestamp::length), entry.start) ||
+        (! _entries.empty () && entry.start < _entries.back ().start))
+    {
+      clear ();
+      return false;
+    }
+
+    entry.length = line.length ();
+    size += line.length () + 1;
+
+    _entries.push_back (entry);
+  }
+
+  _data_size = size;
+
+  records.reserve (records.length () + (_entries.size () - first) * RECORD_WIDTH);
+  for (auto i = first; i < _entries.size (); ++i)
+  {
+    appendRecord (records, _entries[i]);
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Loads the index from file. The index is only accepted if it is at least as
+// recent as the data file and its records end where the data file ends.
+bool DatafileIndex::load (const Path& index, const Path& data)
+{
+  clear ();
+
+  File index_file (index);
+  File data_file (data);
+
+  if (! index_file.exists () ||
+      ! data_file.exists () ||
+      index_file.mtime () < data_file.mtime ())
+  {
+    return false;
+  }
+
+  std::string content;
+  if (! File::read (index._data, content))
+  {
+    return false;
+  }
+
+  auto eol = content.find ('\n');
+  if (eol == std::string::npos)
+  {
+    return false;
+  }
+
+  std::istringstream header (content.substr (0, eol));
+  std::string magic;
+  int version = 0;
+  header >> magic >> version;
+
+  if (magic != INDEX_MAGIC ||
+      version != INDEX_VERSION ||
+      (content.length () - eol - 1) % RECORD_WIDTH != 0)
+  {
+    return false;
+  }
+
+  uint32_t data_size = 0;
+  _entries.reserve ((content.length () - eol - 1) / RECORD_WIDTH);
+  for (auto offset = eol + 1; offset < content.length (); offset += RECORD_WIDTH)
+  {
+    uint32_t start;
+    Entry entry;
+
+    if (! parseHex (content, offset,                   start)        ||
+        ! parseHex (content, offset + FIELD_WIDTH + 1, entry.length) ||
+        (! _entries.empty () && start < _entries.back ().start))
+    {
+      clear ();
+      return false;
+    }
+
+    entry.start = start;
+    data_size += entry.length + 1;
+    _entries.push_back (entry);
+  }
+
+  if (data_size != data_file.size ())
+  {
+    clear ();
+    return false;
+  }
+
+  _data_size = data_size;
+  _valid = true;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string DatafileIndex::serialize () const
+{
+  std::string out = INDEX_MAGIC + ' ' + std::to_string (INDEX_VERSION) + '\n';
+  out.reserve (out.length () + _entries.size () * RECORD_WIDTH);
+
+  for (auto& entry : _entries)
+  {
+    appendRecord (out, entry);
+  }
+
+  return out;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DatafileIndex::clear ()
+{
+  _entries.clear ();
+  _data_size = 0;
+  _valid = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool DatafileIndex::valid () const
+{
+  return _valid;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned int DatafileIndex::size () const
+{
+  return _entries.size ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Position of the first entry starting at or after the given time. Entries are
+// sorted by start time, so this is a binary search.
+unsigned int DatafileIndex::lowerBound (time_t start) const
+{
+  auto it = std::lower_bound (_entries.begin (), _entries.end (), start,
+                              [] (const Entry& entry, time_t value)
+                              {
+                                return entry.start < value;
+                              });
+
+  return it - _entries.begin ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_DATAFILEINDEX
+#define INCLUDED_DATAFILEINDEX
+
+#include <FS.h>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Sidecar index for a data file, stored as YYYY-MM.idx next to YYYY-MM.data.
+// It holds one fixed-width record per line of the data file, in the same
+// order, so that the start of each interval is known without decoding the
+// line. Only a data file sorted by start has an index.
+class DatafileIndex
+{
+public:
+  struct Entry
+  {
+    time_t   start  {0};
+    uint32_t length {0};
+  };
+
+  DatafileIndex () = default;
+
+  void build (const std::vector <std::string_view>&);
+  bool append (const std::vector <std::string_view>&, std::string&);
+  bool load (const Path&, const Path&);
+  std::string serialize () const;
+  void clear ();
+
+  bool valid () const;
+  unsigned int size () const;
+  unsigned int lowerBound (time_t) const;
+
+private:
+  std::vector <Entry> _entries   {};
+  uint32_t            _data_size {0};
+  bool                _valid     {false};
+};
+
+#endif
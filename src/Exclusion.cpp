@@ -26,11 +26,17 @@
 
 #include <Datetime.h>
 #include <Exclusion.h>
+#include <IsoTimestamp.h>
 #include <Pig.h>
 #include <algorithm>
 #include <format.h>
 #include <shared.h>
 
+static const int SECONDS_PER_DAY = 86400;
+
+// 1970-01-01, day number 0, was a Thursday.
+static const int THURSDAY = 4;
+
 ////////////////////////////////////////////////////////////////////////////////
 // An exclusion represents untrackable time such as holidays, weekends, evenings
 // and lunch. There are none by default, but they may be configured. Once there
@@ -56,31 +62,38 @@ Exclusion::Exclusion (const std::string& name, const std::string& value)
   for (auto& token : split (value))
     _tokens.push_back (token);
 
-  // Validate syntax only. Do nothing with the data.
-  if (_tokens.size () >= 2 &&
-      _tokens[0] == "exclusions")
+  int dayOfWeek;
+  if (_tokens.size () == 4 &&
+      _tokens[0] == "exclusions" &&
+      _tokens[1] == "days" &&
+      (_tokens[3] == "on" ||
+       _tokens[3] == "off"))
   {
-    if (_tokens.size () == 4 &&
-        _tokens[1] == "days"  &&
-        _tokens[3] == "on") {
-      _additive = true;
-      return;
-    }
-    if (_tokens.size () == 4 &&
-        _tokens[1] == "days"  &&
-        _tokens[3] == "off")
-    {
-      _additive = false;
-      return;
-    }
-    else if (Datetime::dayOfWeek (_tokens[1]) != -1)
-    {
-      _additive = false;
-      return;
-    }
+    _additive = _tokens[3] == "on";
+
+    auto day = _tokens[2];
+    std::replace (day.begin (), day.end (), '_', '-');
+    Datetime date (day);
+    _day = IsoTimestamp::daysFromCivil (date.year (), date.month (), date.day ());
+    _blocks.push_back ({0, SECONDS_PER_DAY});
   }
+  else if (_tokens.size () >= 2 &&
+           _tokens[0] == "exclusions" &&
+           (dayOfWeek = Datetime::dayOfWeek (_tokens[1])) != -1)
+  {
+    _additive = false;
+    _weekly = true;
+    _day = (dayOfWeek - THURSDAY + 7) % 7;
+
+    for (unsigned int block = 2; block < _tokens.size (); ++block)
+      _blocks.push_back (blockFromToken (_tokens[block]));
 
-  throw format ("Unrecognized exclusion syntax: '{1}' '{2}'.", name, value);
+    std::stable_sort (_blocks.begin (), _blocks.end (), [] (const Block& left, const Block& right) { return left.start < right.start; });
+  }
+  else
+  {
+    throw format ("Unrecognized exclusion syntax: '{1}' '{2}'.", name, value);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -89,6 +102,12 @@ std::vector <std::string> Exclusion::tokens () const
   return _tokens;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+Exclusion::Cursor Exclusion::cursor (const Range& range) const
+{
+  return Cursor (*this, range);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Within range, yield a collection of recurring ranges as defined by _tokens.
 //
@@ -100,53 +119,11 @@ std::vector <std::string> Exclusion::tokens () const
 std::vector <Range> Exclusion::ranges (const Range& range) const
 {
   std::vector <Range> results;
-  int dayOfWeek;
-
-  if (_tokens[1] == "days" &&
-      (_tokens[3] == "on" ||
-       _tokens[3] == "off"))
-  {
-    auto day = _tokens[2];
-    std::replace (day.begin (), day.end (), '_', '-');
-    Datetime start (day);
-    Datetime end (start);
-    ++end;
-    Range all_day (start, end);
-    if (range.overlaps (all_day))
-      results.push_back (all_day);
-  }
-
-  else if ((dayOfWeek = Datetime::dayOfWeek (_tokens[1])) != -1)
-  {
-    Datetime start (range.start.year (), range.start.month (), range.start.day (), 0, 0, 0);
 
-    Range myRange = {range};
-
-    if (myRange.is_open ())
-    {
-      myRange.end = Datetime ();
-    }
-
-    while (start <= myRange.end)
-    {
-      if (start.dayOfWeek () == dayOfWeek)
-      {
-        Datetime end = start;
-        ++end;
-
-        // Now that 'start' and 'end' represent the correct day, compose a set
-        // of Range objects for each time block.
-        for (unsigned int block = 2; block < _tokens.size (); ++block)
-        {
-          auto r = rangeFromTimeBlock (_tokens[block], start, end);
-          if (myRange.overlaps (r))
-            results.push_back (r);
-        }
-      }
-
-      ++start;
-    }
-  }
+  auto exclusions = cursor (range);
+  Range next;
+  while (exclusions.next (next))
+    results.push_back (next);
 
   return results;
 }
@@ -157,6 +134,12 @@ bool Exclusion::additive () const
   return _additive;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool Exclusion::weekly () const
+{
+  return _weekly;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::string Exclusion::dump () const
 {
@@ -164,10 +147,7 @@ std::string Exclusion::dump () const
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-Range Exclusion::rangeFromTimeBlock (
-  const std::string& block,
-  const Datetime& start,
-  const Datetime& end) const
+Exclusion::Block Exclusion::blockFromToken (const std::string& block)
 {
   Pig pig (block);
 
@@ -175,15 +155,13 @@ Range Exclusion::rangeFromTimeBlock (
   {
     int hh, mm, ss;
     if (pig.getHMS (hh, mm, ss))
-      return Range (Datetime (start.year (), start.month (), start.day (),  0,  0,  0),
-                    Datetime (start.year (), start.month (), start.day (), hh, mm, ss));
+      return {0, hh * 3600 + mm * 60 + ss};
   }
   else if (pig.skip ('>'))
   {
     int hh, mm, ss;
     if (pig.getHMS (hh, mm, ss))
-      return Range (Datetime (start.year (), start.month (), start.day (), hh, mm, ss),
-                    Datetime (end.year (),   end.month (),   end.day (),    0,  0,  0));
+      return {hh * 3600 + mm * 60 + ss, SECONDS_PER_DAY};
   }
   else
   {
@@ -192,12 +170,68 @@ Range Exclusion::rangeFromTimeBlock (
     if (pig.getHMS (hh1, mm1, ss1) &&
         pig.skip ('-')             &&
         pig.getHMS (hh2, mm2, ss2))
-      return Range (
-               Datetime (start.year (), start.month (), start.day (), hh1, mm1, ss1),
-               Datetime (start.year (), start.month (), start.day (), hh2, mm2, ss2));
+      return {hh1 * 3600 + mm1 * 60 + ss1, hh2 * 3600 + mm2 * 60 + ss2};
   }
 
   throw format ("Malformed time block '{1}'.", block);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// The local time, seconds after the midnight that starts the given day. Going
+// through the calendar date keeps days that change to or from daylight saving
+// time at their true length.
+Datetime Exclusion::timeOfDay (long day, int seconds)
+{
+  int year, month, dayOfMonth;
+  IsoTimestamp::civilFromDays (day + seconds / SECONDS_PER_DAY, year, month, dayOfMonth);
+  seconds %= SECONDS_PER_DAY;
+
+  return Datetime (year, month, dayOfMonth, seconds / 3600, seconds / 60 % 60, seconds % 60);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Weekday exclusions end at the current time for an open range, while a day
+// exclusion may lie in the future.
+Exclusion::Cursor::Cursor (const Exclusion& exclusion, const Range& range) :
+  _exclusion (exclusion), _range (range)
+{
+  if (! _exclusion._weekly)
+  {
+    _day = _last = _exclusion._day;
+    return;
+  }
+
+  if (_range.is_open ())
+    _range.end = Datetime ();
+
+  auto first = IsoTimestamp::daysFromCivil (_range.start.year (), _range.start.month (), _range.start.day ());
+  _day = first + ((_exclusion._day - first) % 7 + 7) % 7;
+  _last = IsoTimestamp::daysFromCivil (_range.end.year (), _range.end.month (), _range.end.day ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Exclusion::Cursor::next (Range& result)
+{
+  const auto& blocks = _exclusion._blocks;
+
+  while (_day <= _last)
+  {
+    while (_block < blocks.size ())
+    {
+      auto& block = blocks[_block++];
+      Range candidate (timeOfDay (_day, block.start), timeOfDay (_day, block.end));
+      if (_range.overlaps (candidate))
+      {
+        result = candidate;
+        return true;
+      }
+    }
+
+    _day += 7;
+    _block = 0;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
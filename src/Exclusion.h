@@ -34,19 +34,57 @@
 
 class Exclusion
 {
+private:
+  // A time block, as seconds after midnight. An end of SECONDS_PER_DAY is the
+  // following midnight.
+  struct Block
+  {
+    int start;
+    int end;
+  };
+
 public:
+  // Yields the ranges of an exclusion that intersect a range, in order. Only
+  // the days that carry the exclusion are visited, and a range is only built
+  // when it is asked for.
+  class Cursor
+  {
+  public:
+    bool next (Range&);
+
+  private:
+    friend class Exclusion;
+    Cursor (const Exclusion&, const Range&);
+
+    const Exclusion& _exclusion;
+    Range            _range;
+    long             _day   {0};
+    long             _last  {0};
+    unsigned int     _block {0};
+  };
+
   Exclusion (const std::string&, const std::string&);
   std::vector <std::string> tokens () const;
+  Cursor cursor (const Range&) const;
   std::vector <Range> ranges (const Range&) const;
   bool additive () const;
+  bool weekly () const;
   std::string dump () const;
 
 private:
-  Range rangeFromTimeBlock (const std::string&, const Datetime&, const Datetime&) const;
+  static Block blockFromToken (const std::string&);
+  static Datetime timeOfDay (long, int);
 
 private:
   std::vector <std::string> _tokens   {};
   bool                      _additive {false};
+
+  // Weekday exclusions repeat every seven days from _day, which is a day
+  // number as in IsoTimestamp::daysFromCivil. Day exclusions only apply to
+  // _day itself.
+  bool                      _weekly   {false};
+  long                      _day      {0};
+  std::vector <Block>       _blocks   {};
 };
 
 #endif
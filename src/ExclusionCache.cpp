@@ -0,0 +1,343 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <AtomicFile.h>
+#include <Datetime.h>
+#include <ExclusionCache.h>
+#include <FS.h>
+#include <cstdlib>
+#include <format.h>
+#include <iomanip>
+#include <shared.h>
+#include <sstream>
+#include <timew.h>
+
+std::string ExclusionCache::file {};
+std::string ExclusionCache::state {};
+
+// The most months kept in the cache file.
+static const unsigned int MAX_MONTHS = 36;
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string monthName (int key)
+{
+  std::stringstream out;
+  out << key / 12 << '-' << std::setw (2) << std::setfill ('0') << key % 12 + 1;
+  return out.str ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static int monthKey (const Datetime& datetime)
+{
+  return datetime.year () * 12 + datetime.month () - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Ranges are written as epoch pairs: ' <start>-<end> ...'.
+static std::string serialize (const std::vector <Range>& ranges)
+{
+  std::stringstream out;
+  for (auto& range : ranges)
+    out << ' ' << range.start.toEpoch () << '-' << range.end.toEpoch ();
+
+  return out.str ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static std::vector <Range> unserialize (const std::vector <std::string>& words, unsigned int first)
+{
+  std::vector <Range> ranges;
+  for (auto word = words.begin () + first; word != words.end (); ++word)
+  {
+    auto dash = word->find ('-');
+    if (dash == std::string::npos)
+      throw format ("Malformed range '{1}'.", *word);
+
+    ranges.emplace_back (Datetime (static_cast <time_t> (std::stoll (word->substr (0, dash)))),
+                         Datetime (static_cast <time_t> (std::stoll (word->substr (dash + 1)))));
+  }
+
+  return ranges;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The cached ranges are only expanded on a miss, so the rules are only parsed
+// when the file is missing or stale.
+ExclusionCache::ExclusionCache (const Rules& rules) :
+  _fingerprint (rules.exclusionFingerprint ())
+{
+  for (auto& name : rules.all ("exclusions."))
+    _rules.emplace_back (lowerCase (name), rules.get (name));
+
+  if (load ())
+    return;
+
+  _holidays = getHolidays (rules);
+
+  // Starting at the epoch and open, this range overlaps every day exclusion.
+  Range always {Datetime (static_cast <time_t> (1)), Datetime (static_cast <time_t> (0))};
+  for (auto& exclusion : definitions ())
+    if (! exclusion.weekly ())
+      for (auto& range : exclusion.ranges (always))
+        _days.push_back (range);
+
+  _modified = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const std::string& ExclusionCache::fingerprint () const
+{
+  return _fingerprint;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const std::vector <Range>& ExclusionCache::holidays () const
+{
+  return _holidays;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The day exclusions, and the weekday exclusions of the months the range
+// touches, that overlap the range. Weekday exclusions end at the current time
+// for an open range, while a day exclusion may lie in the future.
+std::vector <Range> ExclusionCache::exclusions (const Range& range)
+{
+  std::vector <Range> results;
+  for (auto& day : _days)
+    if (range.overlaps (day))
+      results.push_back (day);
+
+  Range limits {range};
+  if (limits.is_open ())
+    limits.end = Datetime ();
+
+  if (! limits.is_started () || limits.end < limits.start)
+    return results;
+
+  auto last = monthKey (Datetime (limits.end.toEpoch () - 1));
+  for (auto key = monthKey (limits.start); key <= last; ++key)
+    for (auto& exclusion : month (key))
+      if (limits.overlaps (exclusion))
+        results.push_back (exclusion);
+
+  return results;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ExclusionCache::save ()
+{
+  if (file.empty ())
+    return;
+
+  prune ();
+  if (! _modified)
+    return;
+
+  std::vector <std::string> lines;
+  lines.push_back ("fingerprint " + _fingerprint);
+  lines.push_back ("holidays" + serialize (_holidays));
+  lines.push_back ("days" + serialize (_days));
+  for (auto& month : _months)
+    lines.push_back ("month " + monthName (month.first) + serialize (month.second));
+
+  AtomicFile::write (Path (file), lines);
+  _modified = false;
+  _expanded.clear ();
+
+  debug (format ("Saved exclusions for {1} months to '{2}'", _months.size (), file));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The exclusions remembered for an open interval that started at the given
+// time, and the cut-off up to which they are complete. Only a state written
+// for the same start, and for the same rules, is recalled.
+bool ExclusionCache::recall (
+  const Datetime& start,
+  Datetime& cutoff,
+  std::vector <Range>& exclusions) const
+{
+  if (state.empty ())
+    return false;
+
+  AtomicFile memo (state);
+  if (! memo.exists ())
+    return false;
+
+  std::vector <std::string> lines;
+  memo.read (lines);
+  if (lines.size () != 4 ||
+      lines[0] != "fingerprint " + _fingerprint ||
+      lines[1] != "start " + std::to_string (start.toEpoch ()))
+    return false;
+
+  try
+  {
+    auto words = split (lines[2], ' ');
+    if (words.size () != 2 || words[0] != "cutoff")
+      return false;
+
+    auto ranges = split (lines[3], ' ');
+    if (ranges[0] != "exclusions")
+      return false;
+
+    cutoff = Datetime (static_cast <time_t> (std::stoll (words[1])));
+    exclusions = unserialize (ranges, 1);
+  }
+
+  catch (...)
+  {
+    return false;
+  }
+
+  debug (format ("Recalled {1} exclusions up to {2}", exclusions.size (), cutoff.toISOLocalExtended ()));
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ExclusionCache::remember (
+  const Datetime& start,
+  const Datetime& cutoff,
+  const std::vector <Range>& exclusions) const
+{
+  if (state.empty ())
+    return;
+
+  AtomicFile::write (Path (state), {"fingerprint " + _fingerprint,
+                                    "start " + std::to_string (start.toEpoch ()),
+                                    "cutoff " + std::to_string (cutoff.toEpoch ()),
+                                    "exclusions" + serialize (exclusions)});
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A cache file written for other rules is ignored, and replaced on save. So is
+// one that cannot be read.
+bool ExclusionCache::load ()
+{
+  if (file.empty ())
+    return false;
+
+  AtomicFile cache (file);
+  if (! cache.exists ())
+    return false;
+
+  std::vector <std::string> lines;
+  cache.read (lines);
+  if (lines.empty () || lines[0] != "fingerprint " + _fingerprint)
+  {
+    debug (format ("Exclusion cache '{1}' is stale", file));
+    return false;
+  }
+
+  try
+  {
+    for (unsigned int i = 1; i < lines.size (); ++i)
+    {
+      auto words = split (lines[i], ' ');
+      if (words[0] == "holidays")
+        _holidays = unserialize (words, 1);
+      else if (words[0] == "days")
+        _days = unserialize (words, 1);
+      else if (words[0] == "month" && words.size () >= 2 && words[1].size () == 7)
+        _months[std::stoi (words[1].substr (0, 4)) * 12 + std::stoi (words[1].substr (5)) - 1] = unserialize (words, 2);
+      else
+        throw format ("Unrecognized line '{1}'.", lines[i]);
+    }
+  }
+
+  catch (...)
+  {
+    debug (format ("Exclusion cache '{1}' is unreadable", file));
+    _holidays.clear ();
+    _days.clear ();
+    _months.clear ();
+    return false;
+  }
+
+  debug (format ("Loaded exclusions for {1} months from '{2}'", _months.size (), file));
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The weekday exclusions that lie in a month, expanded on first use.
+const std::vector <Range>& ExclusionCache::month (int key)
+{
+  auto found = _months.find (key);
+  if (found != _months.end ())
+    return found->second;
+
+  Range whole {Datetime (key / 12, key % 12 + 1, 1, 0, 0, 0),
+               Datetime ((key + 1) / 12, (key + 1) % 12 + 1, 1, 0, 0, 0)};
+
+  std::vector <Range> ranges;
+  for (auto& exclusion : definitions ())
+    if (exclusion.weekly ())
+      for (auto& range : exclusion.ranges (whole))
+        if (! range.is_empty ())
+          ranges.push_back (range);
+
+  debug (format ("Expanded {1} exclusions for {2}", ranges.size (), monthName (key)));
+  _expanded.insert (key);
+  return _months[key] = std::move (ranges);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Keeps the months nearest to the current one. The file only needs rewriting
+// if a month it holds is dropped, or a newly expanded month is kept.
+void ExclusionCache::prune ()
+{
+  auto now = monthKey (Datetime ());
+  while (_months.size () > MAX_MONTHS)
+  {
+    auto farthest = std::abs (_months.begin ()->first - now) > std::abs (_months.rbegin ()->first - now)
+                  ? _months.begin ()->first
+                  : _months.rbegin ()->first;
+
+    if (_expanded.erase (farthest) == 0)
+      _modified = true;
+
+    _months.erase (farthest);
+  }
+
+  if (! _expanded.empty ())
+    _modified = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const std::vector <Exclusion>& ExclusionCache::definitions ()
+{
+  if (! _parsed)
+  {
+    for (auto& rule : _rules)
+      _exclusions.emplace_back (rule.first, rule.second);
+
+    debug (format ("Found {1} exclusions", _exclusions.size ()));
+    _parsed = true;
+  }
+
+  return _exclusions;
+}
+
+////////////////////////////////////////////////////////////////////////////////
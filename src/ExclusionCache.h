@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_EXCLUSIONCACHE
+#define INCLUDED_EXCLUSIONCACHE
+
+#include <Exclusion.h>
+#include <Range.h>
+#include <Rules.h>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The holidays and exclusions of a configuration, expanded into ranges. The
+// expansion is kept in a file and reused by later runs, for as long as the
+// fingerprint of the 'holidays.*' and 'exclusions.*' rules is unchanged.
+class ExclusionCache
+{
+public:
+  // The cache file, or empty to keep the expansion in memory only.
+  static std::string file;
+
+  // The file remembering the exclusions of the open interval, or empty.
+  static std::string state;
+
+  explicit ExclusionCache (const Rules&);
+
+  const std::string& fingerprint () const;
+  const std::vector <Range>& holidays () const;
+  std::vector <Range> exclusions (const Range&);
+  void save ();
+
+  bool recall (const Datetime&, Datetime&, std::vector <Range>&) const;
+  void remember (const Datetime&, const Datetime&, const std::vector <Range>&) const;
+
+private:
+  bool load ();
+  const std::vector <Range>& month (int);
+  void prune ();
+  const std::vector <Exclusion>& definitions ();
+
+private:
+  std::string                                       _fingerprint {};
+  std::vector <std::pair <std::string, std::string>> _rules       {};
+  std::vector <Exclusion>                           _exclusions  {};
+  bool                                              _parsed      {false};
+  bool                                              _modified    {false};
+
+  std::vector <Range>                               _holidays    {};
+  std::vector <Range>                               _days        {};
+
+  // Weekday exclusions of a whole month, by year * 12 + month - 1, and the
+  // months expanded since the file was read.
+  std::map <int, std::vector <Range>>               _months      {};
+  std::set <int>                                    _expanded    {};
+};
+
+#endif
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <HolidayTable.h>
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////////
+HolidayTable::HolidayTable (std::vector <Holiday> holidays) :
+  _holidays (std::move (holidays))
+{
+  std::sort (_holidays.begin (), _holidays.end (), [] (const Holiday& left, const Holiday& right)
+  {
+    return left.date < right.date || (left.date == right.date && left.locale < right.locale);
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool HolidayTable::empty () const
+{
+  return _holidays.empty ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+size_t HolidayTable::size () const
+{
+  return _holidays.size ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+HolidayTable::const_iterator HolidayTable::begin () const
+{
+  return _holidays.begin ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+HolidayTable::const_iterator HolidayTable::end () const
+{
+  return _holidays.end ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The first holiday on or after the given time.
+HolidayTable::const_iterator HolidayTable::lower_bound (const Datetime& datetime) const
+{
+  return std::lower_bound (_holidays.begin (), _holidays.end (), datetime, [] (const Holiday& holiday, const Datetime& value)
+  {
+    return holiday.date < value;
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The holidays from the start to the end of the range, both included.
+std::vector <HolidayTable::Holiday> HolidayTable::within (const Range& range) const
+{
+  std::vector <Holiday> results;
+  for (auto holiday = lower_bound (range.start); holiday != end () && holiday->date <= range.end; ++holiday)
+    results.push_back (*holiday);
+
+  return results;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Whether the day of the given time is a holiday.
+bool HolidayTable::contains (const Datetime& datetime) const
+{
+  auto midnight = datetime.startOfDay ();
+  auto holiday = lower_bound (midnight);
+
+  return holiday != end () && holiday->date.sameDay (midnight);
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_HOLIDAYTABLE
+#define INCLUDED_HOLIDAYTABLE
+
+#include <Datetime.h>
+#include <Range.h>
+#include <string>
+#include <vector>
+
+// The 'holidays.<locale>.<date>' rules, sorted by date and then locale.
+class HolidayTable
+{
+public:
+  struct Holiday
+  {
+    Datetime    date;
+    std::string locale;
+    std::string name;
+  };
+
+  using const_iterator = std::vector <Holiday>::const_iterator;
+
+  HolidayTable () = default;
+  explicit HolidayTable (std::vector <Holiday>);
+
+  bool empty () const;
+  size_t size () const;
+  const_iterator begin () const;
+  const_iterator end () const;
+
+  const_iterator lower_bound (const Datetime&) const;
+  std::vector <Holiday> within (const Range&) const;
+  bool contains (const Datetime&) const;
+
+private:
+  std::vector <Holiday> _holidays {};
+};
+
+#endif
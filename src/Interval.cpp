@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <Interval.h>
+#include <IsoTimestamp.h>
 #include <JSON.h>
 #include <Lexer.h>
 #include <algorithm>
@@ -63,11 +64,37 @@ bool Interval::empty () const
 ////////////////////////////////////////////////////////////////////////////////
 bool Interval::hasTag (const std::string& tag) const
 {
-  return std::find (_tags.begin (), _tags.end (), tag) != _tags.end ();
+  TagDictionary::Id id;
+  return TagDictionary::find (tag, id) &&
+         std::find (_tags.begin (), _tags.end (), id) != _tags.end ();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-const std::set <std::string>& Interval::tags () const
+// Whether the interval has all of the given tags. An interval has few tags, so
+// looking for each id is quicker than ordering them by name.
+bool Interval::hasTags (const std::vector <TagDictionary::Id>& ids) const
+{
+  for (auto id : ids)
+    if (std::find (_tags.begin (), _tags.end (), id) == _tags.end ())
+      return false;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The tags by name. This builds a new set on every call, so code looking at
+// many intervals should use tagIds () instead.
+std::set <std::string> Interval::tags () const
+{
+  std::set <std::string> tags;
+  for (auto id : _tags)
+    tags.insert (TagDictionary::name (id));
+
+  return tags;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const std::vector <TagDictionary::Id>& Interval::tagIds () const
 {
   return _tags;
 }
@@ -75,33 +102,36 @@ const std::set <std::string>& Interval::tags () const
 ////////////////////////////////////////////////////////////////////////////////
 void Interval::tag (const std::string& tag)
 {
-  _tags.insert (tag);
+  auto id = TagDictionary::intern (tag);
+  auto position = std::lower_bound (_tags.begin (), _tags.end (), id, TagDictionary::less);
+  if (position == _tags.end () || *position != id)
+    _tags.insert (position, id);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Interval::tag (const std::set <std::string>& tags)
 {
-  _tags.insert (tags.begin (), tags.end ());
+  for (auto& tag : tags)
+    this->tag (tag);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Interval::untag (const std::string& tag)
 {
-  _tags.erase (tag);
+  TagDictionary::Id id;
+  if (TagDictionary::find (tag, id))
+  {
+    auto position = std::find (_tags.begin (), _tags.end (), id);
+    if (position != _tags.end ())
+      _tags.erase (position);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Interval::untag (const std::set <std::string>& tags)
 {
-  std::set <std::string> updated;
-
-  std::set_difference (
-    _tags.begin (), _tags.end (),
-    tags.begin (), tags.end (),
-    std::inserter (updated, updated.end ())
-  );
-
-  _tags = updated;
+  for (auto& tag : tags)
+    untag (tag);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -117,16 +147,16 @@ std::string Interval::serialize () const
   out << "inc";
 
   if (start.toEpoch ())
-    out << " " << start.toISO ();
+    out << " " << IsoTimestamp::encode (start.toEpoch ());
 
   if (end.toEpoch ())
-    out << " - " << end.toISO ();
+    out << " - " << IsoTimestamp::encode (end.toEpoch ());
 
   if (! _tags.empty ())
   {
     out << " #";
-    for (auto& tag : _tags)
-      out << ' ' << quoteIfNeeded (tag);
+    for (auto id : _tags)
+      out << ' ' << quoteIfNeeded (TagDictionary::name (id));
   }
 
   if (! annotation.empty ())
@@ -150,23 +180,23 @@ std::string Interval::json () const
 
     if (is_started ())
     {
-      out << ",\"start\":\"" << start.toISO () << "\"";
+      out << ",\"start\":\"" << IsoTimestamp::encode (start.toEpoch ()) << "\"";
     }
 
     if (is_ended ())
     {
-      out << ",\"end\":\"" << end.toISO () << "\"";
+      out << ",\"end\":\"" << IsoTimestamp::encode (end.toEpoch ()) << "\"";
     }
 
     if (! _tags.empty ())
     {
       std::string tags;
-      for (auto& tag : _tags)
+      for (auto id : _tags)
       {
         if (tags[0])
           tags += ',';
 
-        tags += "\"" + json::encode (tag) + "\"";
+        tags += "\"" + json::encode (TagDictionary::name (id)) + "\"";
       }
 
       out << ",\"tags\":["
@@ -203,8 +233,8 @@ std::string Interval::dump () const
   if (! _tags.empty ())
   {
     out << " #";
-    for (auto& tag : _tags)
-      out << ' ' << quoteIfNeeded (tag);
+    for (auto id : _tags)
+      out << ' ' << quoteIfNeeded (TagDictionary::name (id));
   }
 
   if (synthetic)
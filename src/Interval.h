@@ -28,23 +28,26 @@
 #define INCLUDED_INTERVAL
 
 #include <Range.h>
+#include <TagDictionary.h>
 #include <set>
 #include <string>
-#include <utility>
+#include <vector>
 
 class Interval : public Range
 {
 public:
   Interval () = default;
   Interval (const Datetime& start, const Datetime& end) : Range (start, end) {}
-  Interval (const Range& range, std::set <std::string> tags) : Range (range), _tags(std::move(tags)) {}
+  Interval (const Range& range, const std::set <std::string>& tags) : Range (range) { tag (tags); }
 
   bool operator== (const Interval&) const;
   bool operator!= (const Interval&) const;
 
   bool empty () const;
   bool hasTag (const std::string&) const;
-  const std::set <std::string>& tags () const;
+  bool hasTags (const std::vector <TagDictionary::Id>&) const;
+  std::set <std::string> tags () const;
+  const std::vector <TagDictionary::Id>& tagIds () const;
   void tag (const std::string&);
   void tag (const std::set <std::string>&);
   void untag (const std::string&);
@@ -67,7 +70,8 @@ public:
   std::string            annotation {};
 
 private:
-  std::set <std::string> _tags  {};
+  // Ids of the tags, see TagDictionary, sorted by their names.
+  std::vector <TagDictionary::Id> _tags {};
 };
 
 #endif
@@ -0,0 +1,310 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <IntervalDelta.h>
+#include <IntervalFactory.h>
+#include <IsoTimestamp.h>
+#include <algorithm>
+#include <format.h>
+#include <iterator>
+#include <map>
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string quote (const std::string& text)
+{
+  std::string quoted = "\"";
+  for (auto& c : text)
+  {
+    if (c == '"' || c == '\\')
+    {
+      quoted += '\\';
+    }
+
+    quoted += c;
+  }
+
+  return quoted + '"';
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string timestamp (const Datetime& date)
+{
+  return date.toEpoch () == 0 ? "-" : IsoTimestamp::encode (date.toEpoch ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Returns the change entry turning 'before' into 'after', or an empty string
+// if the two are identical.
+static std::string change (const Interval& before, const Interval& after)
+{
+  std::string entry;
+
+  if (before.end != after.end)
+  {
+    entry += " end " + timestamp (before.end) + ' ' + timestamp (after.end);
+  }
+
+  const auto& from = before.tagIds ();
+  const auto& to = after.tagIds ();
+
+  std::vector <TagDictionary::Id> added;
+  std::set_difference (to.begin (), to.end (), from.begin (), from.end (), std::back_inserter (added), TagDictionary::less);
+  for (auto& id : added)
+  {
+    entry += " +" + quote (TagDictionary::name (id));
+  }
+
+  std::vector <TagDictionary::Id> removed;
+  std::set_difference (from.begin (), from.end (), to.begin (), to.end (), std::back_inserter (removed), TagDictionary::less);
+  for (auto& id : removed)
+  {
+    entry += " -" + quote (TagDictionary::name (id));
+  }
+
+  if (before.annotation != after.annotation)
+  {
+    entry += " annotation " + quote (before.annotation) + ' ' + quote (after.annotation);
+  }
+
+  if (entry.empty ())
+  {
+    return entry;
+  }
+
+  return "~ " + IsoTimestamp::encode (after.start.toEpoch ()) + entry;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Pairs every added interval with a removed interval of the same start, and
+// records the pair as a change. The remaining intervals are recorded whole.
+std::vector <std::string> IntervalDelta::encode (
+  const std::vector <Interval>& removed,
+  const std::vector <Interval>& added)
+{
+  std::multimap <time_t, std::size_t> starts;
+  for (std::size_t i = 0; i < removed.size (); ++i)
+  {
+    starts.emplace (removed[i].start.toEpoch (), i);
+  }
+
+  std::vector <bool> paired (removed.size (), false);
+  std::vector <std::string> additions;
+  std::vector <std::string> changes;
+  for (auto& interval : added)
+  {
+    auto match = starts.find (interval.start.toEpoch ());
+    if (match == starts.end ())
+    {
+      additions.push_back ("+ " + interval.serialize ());
+      continue;
+    }
+
+    auto entry = change (removed[match->second], interval);
+    if (! entry.empty ())
+    {
+      changes.push_back (entry);
+    }
+
+    paired[match->second] = true;
+    starts.erase (match);
+  }
+
+  std::vector <std::string> entries;
+  for (std::size_t i = 0; i < removed.size (); ++i)
+  {
+    if (! paired[i])
+    {
+      entries.push_back ("- " + removed[i].serialize ());
+    }
+  }
+
+  entries.insert (entries.end (), additions.begin (), additions.end ());
+  entries.insert (entries.end (), changes.begin (), changes.end ());
+  return entries;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string parseWord (const std::string& line, std::string::size_type& cursor)
+{
+  auto end = line.find (' ', cursor);
+  if (end == std::string::npos)
+  {
+    end = line.size ();
+  }
+
+  auto word = line.substr (cursor, end - cursor);
+  cursor = std::min (end + 1, line.size ());
+  return word;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static time_t parseTimestamp (const std::string& line, std::string::size_type& cursor)
+{
+  auto word = parseWord (line, cursor);
+  if (word == "-")
+  {
+    return 0;
+  }
+
+  time_t epoch;
+  if (word.size () != IsoTimestamp::length || ! IsoTimestamp::decode (word, epoch))
+  {
+    throw format ("Malformed undo record '{1}'.", line);
+  }
+
+  return epoch;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string parseQuoted (const std::string& line, std::string::size_type& cursor)
+{
+  if (cursor >= line.size () || line[cursor] != '"')
+  {
+    throw format ("Malformed undo record '{1}'.", line);
+  }
+
+  std::string text;
+  for (++cursor; cursor < line.size (); ++cursor)
+  {
+    if (line[cursor] == '"')
+    {
+      cursor = std::min (cursor + 2, line.size ());
+      return text;
+    }
+
+    if (line[cursor] == '\\')
+    {
+      ++cursor;
+    }
+
+    if (cursor < line.size ())
+    {
+      text += line[cursor];
+    }
+  }
+
+  throw format ("Malformed undo record '{1}'.", line);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+IntervalDelta IntervalDelta::decode (const std::string& line)
+{
+  if (line.size () < 2 || line[1] != ' ')
+  {
+    throw format ("Malformed undo record '{1}'.", line);
+  }
+
+  IntervalDelta delta;
+  if (line[0] == '+' || line[0] == '-')
+  {
+    delta.kind = line[0] == '+' ? Kind::added : Kind::removed;
+    delta.interval = IntervalFactory::fromSerialization (std::string_view (line).substr (2));
+    return delta;
+  }
+
+  if (line[0] != '~')
+  {
+    throw format ("Malformed undo record '{1}'.", line);
+  }
+
+  std::string::size_type cursor = 2;
+  delta.interval.start = Datetime (parseTimestamp (line, cursor));
+
+  while (cursor < line.size ())
+  {
+    if (line[cursor] == '+' || line[cursor] == '-')
+    {
+      auto& tags = line[cursor] == '+' ? delta.tagsAdded : delta.tagsRemoved;
+      tags.push_back (parseQuoted (line, ++cursor));
+      continue;
+    }
+
+    auto field = parseWord (line, cursor);
+    if (field == "end")
+    {
+      delta.endChanged = true;
+      delta.endBefore = parseTimestamp (line, cursor);
+      delta.endAfter = parseTimestamp (line, cursor);
+    }
+    else if (field == "annotation")
+    {
+      delta.annotationChanged = true;
+      delta.annotationBefore = parseQuoted (line, cursor);
+      delta.annotationAfter = parseQuoted (line, cursor);
+    }
+    else
+    {
+      throw format ("Malformed undo record '{1}'.", line);
+    }
+  }
+
+  return delta;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Whether 'after' is in the state this change left it in.
+bool IntervalDelta::matches (const Interval& after) const
+{
+  if (after.start != interval.start ||
+      (endChanged && after.end.toEpoch () != endAfter) ||
+      (annotationChanged && after.annotation != annotationAfter))
+  {
+    return false;
+  }
+
+  return std::all_of (tagsAdded.begin (), tagsAdded.end (), [&after] (const std::string& tag) { return after.hasTag (tag); }) &&
+         std::none_of (tagsRemoved.begin (), tagsRemoved.end (), [&after] (const std::string& tag) { return after.hasTag (tag); });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Interval IntervalDelta::revert (const Interval& after) const
+{
+  Interval before = after;
+
+  if (endChanged)
+  {
+    before.end = Datetime (endBefore);
+  }
+
+  for (auto& tag : tagsAdded)
+  {
+    before.untag (tag);
+  }
+
+  for (auto& tag : tagsRemoved)
+  {
+    before.tag (tag);
+  }
+
+  if (annotationChanged)
+  {
+    before.annotation = annotationBefore;
+  }
+
+  return before;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_INTERVALDELTA
+#define INCLUDED_INTERVALDELTA
+
+#include <Interval.h>
+#include <ctime>
+#include <string>
+#include <vector>
+
+// One entry of a compact undo record. Intervals that were only added or only
+// removed are stored whole, in their serialized form:
+//
+//   + inc 20260101T090000Z - 20260101T100000Z # foo
+//   - inc 20260101T090000Z - 20260101T100000Z # foo
+//
+// An interval that was replaced by one with the same start is stored as that
+// start plus the fields that changed:
+//
+//   ~ 20260101T090000Z end 20260101T100000Z 20260101T110000Z +"bar" -"foo"
+//
+// An 'end' of '-' means open, and 'annotation' is followed by the old and the
+// new annotation.
+class IntervalDelta
+{
+public:
+  enum class Kind { added, removed, changed };
+
+  static std::vector <std::string> encode (const std::vector <Interval>&, const std::vector <Interval>&);
+  static IntervalDelta decode (const std::string&);
+
+  bool matches (const Interval&) const;
+  Interval revert (const Interval&) const;
+
+public:
+  Kind                      kind              {Kind::changed};
+  Interval                  interval          {};  // Only the start, for a change.
+  bool                      endChanged        {false};
+  time_t                    endBefore         {0};
+  time_t                    endAfter          {0};
+  std::vector <std::string> tagsAdded         {};
+  std::vector <std::string> tagsRemoved       {};
+  bool                      annotationChanged {false};
+  std::string               annotationBefore  {};
+  std::string               annotationAfter   {};
+};
+
+#endif
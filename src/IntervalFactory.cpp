@@ -25,15 +25,208 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <IntervalFactory.h>
+#include <IsoTimestamp.h>
 #include <JSON.h>
 #include <Lexer.h>
+#include <array>
 #include <format.h>
+#include <timew.h>
 
-static std::vector <std::string> tokenizeSerialization (const std::string& line) 
+bool IntervalFactory::verifySerialization = false;
+
+////////////////////////////////////////////////////////////////////////////////
+// A token of a serialized interval, as a view into the line. Quoted tokens are
+// stored without their quotes, and may still contain escaped quotes.
+struct SerializationToken
+{
+  std::string_view text    {};
+  bool             quoted  {false};
+  bool             escaped {false};
+
+  bool is (std::string_view literal) const
+  {
+    return ! escaped && text == literal;
+  }
+
+  std::string::size_type length () const
+  {
+    return escaped ? str ().length () : text.length ();
+  }
+
+  std::string str () const
+  {
+    if (! escaped)
+      return std::string (text);
+
+    std::string out;
+    out.reserve (text.length ());
+    for (std::string::size_type i = 0; i < text.length (); ++i)
+    {
+      if (text[i] == '\\' && i + 1 < text.length () && text[i + 1] == '"')
+        ++i;
+
+      out += text[i];
+    }
+
+    return out;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Unquoted words are limited to those the Lexer is known to return unchanged
+// as a single token: letters and digits, starting with a letter, or digits
+// only.
+static bool isPlainWord (std::string_view word)
+{
+  if (word.empty ())
+    return false;
+
+  auto isAlpha = [] (char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); };
+  auto isDigit = [] (char c) { return c >= '0' && c <= '9'; };
+
+  bool digits = isDigit (word[0]);
+  if (! digits && ! isAlpha (word[0]))
+    return false;
+
+  for (auto c : word)
+    if (! isDigit (c) && (digits || ! isAlpha (c)))
+      return false;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Returns the length of the well-formed UTF-8 sequence at the start of text,
+// or 0 if it is malformed, overlong, a surrogate or beyond U+10FFFF. The Lexer
+// re-encodes every character of a quoted string, which only preserves
+// well-formed sequences.
+static int utf8SequenceLength (std::string_view text)
+{
+  auto byte = [&text] (std::string::size_type i) { return static_cast <unsigned char> (text[i]); };
+  auto trail = [&] (std::string::size_type i) { return i < text.length () && (byte (i) & 0xC0) == 0x80; };
+
+  auto first = byte (0);
+  if (first < 0x80)
+    return 1;
+
+  if (first >= 0xC2 && first <= 0xDF)
+    return trail (1) ? 2 : 0;
+
+  if (first >= 0xE0 && first <= 0xEF)
+  {
+    if (! trail (1) || ! trail (2))
+      return 0;
+    if ((first == 0xE0 && byte (1) < 0xA0) ||
+        (first == 0xED && byte (1) > 0x9F))
+      return 0;
+    return 3;
+  }
+
+  if (first >= 0xF0 && first <= 0xF4)
+  {
+    if (! trail (1) || ! trail (2) || ! trail (3))
+      return 0;
+    if ((first == 0xF0 && byte (1) < 0x90) ||
+        (first == 0xF4 && byte (1) > 0x8F))
+      return 0;
+    return 4;
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The outcome of reading a token: one was read, the line has ended, or the
+// token is outside of the subset that scanSerialization () decodes.
+enum class Scan { token, end, unsupported };
+
+////////////////////////////////////////////////////////////////////////////////
+// Reads the next token.
+static Scan scanToken (
+  std::string_view line,
+  std::string_view::size_type& cursor,
+  SerializationToken& token)
+{
+  while (cursor < line.length () && line[cursor] == ' ')
+    ++cursor;
+
+  if (cursor == line.length ())
+    return Scan::end;
+
+  token.quoted = line[cursor] == '"';
+  token.escaped = false;
+
+  if (token.quoted)
+  {
+    auto start = ++cursor;
+    while (true)
+    {
+      if (cursor == line.length ())
+        return Scan::unsupported;
+
+      auto c = line[cursor];
+      if (c == '"')
+        break;
+
+      // Only escaped quotes are decoded here. Any other escape, and the
+      // U+XXXX notation, are left to the Lexer.
+      if (c == '\\')
+      {
+        if (cursor + 1 == line.length () || line[cursor + 1] != '"')
+          return Scan::unsupported;
+
+        token.escaped = true;
+        cursor += 2;
+      }
+      else if (c == 'U' && cursor + 1 < line.length () && line[cursor + 1] == '+')
+      {
+        return Scan::unsupported;
+      }
+      else
+      {
+        auto length = utf8SequenceLength (line.substr (cursor));
+        if (length == 0)
+          return Scan::unsupported;
+
+        cursor += length;
+      }
+    }
+
+    token.text = line.substr (start, cursor - start);
+    ++cursor;
+
+    if (cursor < line.length () && line[cursor] != ' ')
+      return Scan::unsupported;
+
+    return Scan::token;
+  }
+
+  auto start = cursor;
+  while (cursor < line.length () && line[cursor] != ' ')
+    ++cursor;
+
+  token.text = line.substr (start, cursor - start);
+  return Scan::token;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Stored timestamps are in the compact UTC form, which is decoded directly.
+// Anything else is left to Datetime.
+static Datetime decodeDatetime (const std::string& text)
+{
+  time_t epoch;
+  if (IsoTimestamp::decode (text, epoch))
+    return Datetime (epoch);
+
+  return Datetime (text);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static std::vector <std::string> tokenizeSerialization (std::string_view line)
 {
   std::vector <std::string> tokens;
 
-  Lexer lexer (line);
+  Lexer lexer (std::string {line});
   std::string token;
   Lexer::Type type;
   
@@ -59,7 +252,131 @@ static std::vector <std::string> tokenizeSerialization (const std::string& line)
 ////////////////////////////////////////////////////////////////////////////////
 // Syntax:
 //   'inc' [ <iso> [ '-' <iso> ]] [ '#' <tag> [ <tag> ... ]]
-Interval IntervalFactory::fromSerialization (const std::string& line)
+//
+// Lines are decoded by scanSerialization (), which handles everything written
+// by Interval::serialize () for ordinary tags and annotations. Anything else
+// goes through the general purpose Lexer. With verification enabled, every
+// scanned line is also decoded by the Lexer and both results are compared.
+Interval IntervalFactory::fromSerialization (std::string_view line)
+{
+  Interval interval;
+  if (! scanSerialization (line, interval))
+  {
+    return lexSerialization (line);
+  }
+
+  if (verifySerialization)
+  {
+    auto lexed = lexSerialization (line);
+    if (lexed != interval)
+    {
+      throw format ("Serialization decoders disagree on '{1}':\n  {2}\nis not equal to:\n  {3}",
+                    std::string (line), interval.dump (), lexed.dump ());
+    }
+  }
+
+  return interval;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Single pass decoder without the Lexer. It follows the same grammar as
+// lexSerialization (), but returns false for any line containing something
+// outside of the subset it can decode identically.
+bool IntervalFactory::scanSerialization (std::string_view line, Interval& interval)
+{
+  std::array <SerializationToken, 32> tokens;
+  std::string::size_type count = 0;
+  std::string_view::size_type cursor = 0;
+
+  Scan scan;
+  while ((scan = scanToken (line, cursor, tokens[count])) == Scan::token)
+  {
+    if (++count == tokens.size ())
+      return false;
+  }
+
+  if (scan == Scan::unsupported)
+    return false;
+
+  if (count == 0 || ! tokens[0].is ("inc"))
+    return false;
+
+  interval = Interval ();
+  unsigned int offset = 0;
+
+  // Optional <iso>
+  if (count > 1 && tokens[1].length () == 16)
+  {
+    time_t start;
+    if (tokens[1].escaped || ! IsoTimestamp::decode (tokens[1].text, start))
+      return false;
+
+    interval.start = Datetime (start);
+    offset = 1;
+
+    // Optional '-' <iso>
+    if (count > 3 && tokens[2].is ("-") && tokens[3].length () == 16)
+    {
+      time_t end;
+      if (tokens[3].escaped || ! IsoTimestamp::decode (tokens[3].text, end))
+        return false;
+
+      interval.end = Datetime (end);
+      offset = 3;
+    }
+  }
+
+  // All remaining unquoted tokens must be separators or plain words.
+  for (auto i = offset + 1; i < count; ++i)
+  {
+    if (! tokens[i].quoted &&
+        ! tokens[i].is ("#") &&
+        ! tokens[i].is ("-") &&
+        ! isPlainWord (tokens[i].text))
+      return false;
+  }
+
+  // Optional '#' <tag>
+  if (count > 2 + offset && tokens[1 + offset].is ("#"))
+  {
+    // Optional <tag> ...
+    auto index = 2 + offset;
+
+    while (index < count && ! tokens[index].is ("#"))
+    {
+      interval.tag (tokens[index].str ());
+      index++;
+    }
+
+    // Optional '#' <annotation>
+    if (index < count && tokens[index].is ("#"))
+    {
+      std::string annotation;
+
+      // Optional <annotation> ...
+      for (auto i = index + 1; i < count; ++i)
+      {
+        if (i > index + 1)
+          annotation += ' ';
+
+        if (tokens[i].escaped)
+          annotation += tokens[i].str ();
+        else
+          annotation += tokens[i].text;
+      }
+
+      interval.setAnnotation (annotation);
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Decodes the line with the general purpose Lexer. This handles all lines,
+// including hand-edited ones, and serves as the reference for
+// scanSerialization ().
+Interval IntervalFactory::lexSerialization (std::string_view line)
 {
   std::vector <std::string> tokens = tokenizeSerialization (line);
 
@@ -74,7 +391,7 @@ Interval IntervalFactory::fromSerialization (const std::string& line)
     if (tokens.size () > 1 &&
         tokens[1].length () == 16)
     {
-      interval.start = Datetime (tokens[1]);
+      interval.start = decodeDatetime (tokens[1]);
       offset = 1;
 
       // Optional '-' <iso>
@@ -82,7 +399,7 @@ Interval IntervalFactory::fromSerialization (const std::string& line)
           tokens[2] == "-"   &&
           tokens[3].length () == 16)
       {
-        interval.end = Datetime (tokens[3]);
+        interval.end = decodeDatetime (tokens[3]);
         offset = 3;
       }
     }
@@ -117,7 +434,7 @@ Interval IntervalFactory::fromSerialization (const std::string& line)
     return interval;
   }
 
-  throw format ("Unrecognizable line '{1}'.", line);
+  throw format ("Unrecognizable line '{1}'.", std::string (line));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -144,9 +461,9 @@ Interval IntervalFactory::fromJson (const std::string& jsonString)
     interval.annotation = (annotation != nullptr) ? json::decode (annotation->_data) : "";
 
     json::string* start = (json::string*) json->_data["start"];
-    interval.start = (start != nullptr) ? Datetime (start->_data) : 0;
+    interval.start = (start != nullptr) ? decodeDatetime (start->_data) : 0;
     json::string* end = (json::string*) json->_data["end"];
-    interval.end = (end != nullptr) ? Datetime(end->_data) : 0;
+    interval.end = (end != nullptr) ? decodeDatetime (end->_data) : 0;
 
     json::number* id = (json::number*) json->_data["id"];
     interval.id = (id != nullptr) ? id->_dvalue : 0;
@@ -29,12 +29,18 @@
 
 #include <Interval.h>
 #include <string>
+#include <string_view>
 
 class IntervalFactory
 {
 public:
-  static Interval fromSerialization (const std::string& line);
+  static Interval fromSerialization (std::string_view line);
   static Interval fromJson (const std::string& jsonString);
+
+  static bool scanSerialization (std::string_view line, Interval& interval);
+  static Interval lexSerialization (std::string_view line);
+
+  static bool verifySerialization;
 };
 
 #endif
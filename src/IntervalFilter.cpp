@@ -41,3 +41,10 @@ void IntervalFilter::reset ()
 {
   set_done (false);
 }
+
+// The range outside of which the filter accepts no interval. It is used as a
+// hint to avoid reading data that cannot match. Unbounded by default.
+Range IntervalFilter::range () const
+{
+  return {};
+}
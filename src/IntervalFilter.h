@@ -28,12 +28,14 @@
 #define INCLUDED_INTERVALFILTER
 
 #include <Interval.h>
+#include <Range.h>
 
 class IntervalFilter
 {
 public:
   virtual bool accepts (const Interval&) = 0;
   virtual void reset ();
+  virtual Range range () const;
   virtual ~IntervalFilter() = default;
 
   bool is_done () const;
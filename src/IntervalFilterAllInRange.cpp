@@ -48,3 +48,8 @@ bool IntervalFilterAllInRange::accepts (const Interval& interval)
 
   return false;
 }
+
+Range IntervalFilterAllInRange::range () const
+{
+  return _range;
+}
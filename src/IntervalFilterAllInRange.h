@@ -36,6 +36,7 @@ public:
   explicit IntervalFilterAllInRange (Range);
 
   bool accepts (const Interval&) final;
+  Range range () const override;
 
 private:
   const Range _range;
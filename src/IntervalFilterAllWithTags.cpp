@@ -27,18 +27,17 @@
 #include <Interval.h>
 #include <IntervalFilterAllWithTags.h>
 
-IntervalFilterAllWithTags::IntervalFilterAllWithTags (std::set <std::string> tags): _tags (std::move (tags))
-{}
-
-bool IntervalFilterAllWithTags::accepts (const Interval& interval)
+// The tags are matched by id, so that testing an interval compares integers
+// instead of strings.
+IntervalFilterAllWithTags::IntervalFilterAllWithTags (std::set <std::string> tags)
 {
-  for (auto& tag : _tags)
+  for (auto& tag : tags)
   {
-    if (! interval.hasTag (tag))
-    {
-      return false;
-    }
+    _tags.push_back (TagDictionary::intern (tag));
   }
+}
 
-  return true;
+bool IntervalFilterAllWithTags::accepts (const Interval& interval)
+{
+  return interval.hasTags (_tags);
 }
@@ -29,8 +29,10 @@
 
 #include <Interval.h>
 #include <IntervalFilter.h>
+#include <TagDictionary.h>
 #include <set>
 #include <string>
+#include <vector>
 
 class IntervalFilterAllWithTags : public IntervalFilter
 {
@@ -40,7 +42,7 @@ public:
   bool accepts (const Interval&) final;
 
 private:
-  const std::set <std::string> _tags {};
+  std::vector <TagDictionary::Id> _tags {};
 };
 
 #endif //INCLUDED_INTERVALFILTERTAGSET
@@ -61,3 +61,27 @@ void IntervalFilterAndGroup::reset ()
     filter->reset ();
   }
 }
+
+// An interval has to be accepted by all filters, so the group range is the
+// intersection of the ranges of its members.
+Range IntervalFilterAndGroup::range () const
+{
+  Range range;
+
+  for (auto& filter: _filters)
+  {
+    auto other = filter->range ();
+
+    if (other.is_started () && (! range.is_started () || range.start < other.start))
+    {
+      range.start = other.start;
+    }
+
+    if (other.is_ended () && (! range.is_ended () || other.end < range.end))
+    {
+      range.end = other.end;
+    }
+  }
+
+  return range;
+}
@@ -37,6 +37,7 @@ public:
 
   bool accepts (const Interval&) final;
   void reset () override;
+  Range range () const override;
 
 private:
   const std::vector <std::shared_ptr <IntervalFilter>> _filters = {};
@@ -47,3 +47,8 @@ void IntervalFilterFirstOf::reset ()
   set_done (false);
   _filter->reset ();
 }
+
+Range IntervalFilterFirstOf::range () const
+{
+  return _filter->range ();
+}
@@ -37,6 +37,7 @@ public:
 
   bool accepts (const Interval&) final;
   void reset ();
+  Range range () const override;
 
 private:
   std::shared_ptr <IntervalFilter> _filter;
@@ -0,0 +1,184 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_ISOTIMESTAMP
+#define INCLUDED_ISOTIMESTAMP
+
+#include <array>
+#include <ctime>
+#include <string>
+#include <string_view>
+
+////////////////////////////////////////////////////////////////////////////////
+// Codec for the compact UTC form YYYYMMDDTHHMMSSZ, in which timestamps are
+// stored in data files and the undo journal. Unlike Datetime, it handles only
+// this one form, and converts without going through the C library.
+class IsoTimestamp
+{
+public:
+  static constexpr std::size_t length = 16;
+
+  static constexpr bool decode (std::string_view, time_t&);
+  static constexpr void encode (time_t, char*);
+  static std::string encode (time_t);
+
+  static constexpr long daysFromCivil (int, int, int);
+  static constexpr void civilFromDays (long, int&, int&, int&);
+
+private:
+  static constexpr int daysInMonth (int, int);
+
+  static constexpr std::array <int, 12> _days_in_month {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+  // The two digit decimal representations of 0 to 99, back to back.
+  static constexpr std::array <char, 200> _digits = []
+  {
+    std::array <char, 200> digits {};
+    for (int i = 0; i < 100; ++i)
+    {
+      digits[i * 2]     = static_cast <char> ('0' + i / 10);
+      digits[i * 2 + 1] = static_cast <char> ('0' + i % 10);
+    }
+
+    return digits;
+  } ();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Returns false, leaving the epoch untouched, if the text is not exactly a
+// valid timestamp in the compact form.
+constexpr bool IsoTimestamp::decode (std::string_view text, time_t& epoch)
+{
+  if (text.length () != length || text[8] != 'T' || text[15] != 'Z')
+    return false;
+
+  int value[14] {};
+  for (std::size_t i = 0, j = 0; i < 15; ++i)
+  {
+    if (i == 8)
+      continue;
+
+    if (text[i] < '0' || text[i] > '9')
+      return false;
+
+    value[j++] = text[i] - '0';
+  }
+
+  int y  = value[0] * 1000 + value[1] * 100 + value[2] * 10 + value[3];
+  int m  = value[4] * 10 + value[5];
+  int d  = value[6] * 10 + value[7];
+  int hh = value[8] * 10 + value[9];
+  int mm = value[10] * 10 + value[11];
+  int ss = value[12] * 10 + value[13];
+
+  if (m < 1 || m > 12 || d < 1 || d > daysInMonth (y, m) ||
+      hh > 23 || mm > 59 || ss > 59)
+    return false;
+
+  epoch = static_cast <time_t> (daysFromCivil (y, m, d)) * 86400 + hh * 3600 + mm * 60 + ss;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writes exactly IsoTimestamp::length characters, without a terminating NUL.
+// Supports years 0 to 9999.
+constexpr void IsoTimestamp::encode (time_t epoch, char* out)
+{
+  auto days = static_cast <long> (epoch / 86400);
+  auto seconds = static_cast <int> (epoch % 86400);
+  if (seconds < 0)
+  {
+    seconds += 86400;
+    --days;
+  }
+
+  int y = 0, m = 0, d = 0;
+  civilFromDays (days, y, m, d);
+
+  auto put = [&out] (std::size_t offset, int value)
+  {
+    out[offset]     = _digits[value * 2];
+    out[offset + 1] = _digits[value * 2 + 1];
+  };
+
+  put (0, y / 100);
+  put (2, y % 100);
+  put (4, m);
+  put (6, d);
+  out[8] = 'T';
+  put (9, seconds / 3600);
+  put (11, seconds / 60 % 60);
+  put (13, seconds % 60);
+  out[15] = 'Z';
+}
+
+////////////////////////////////////////////////////////////////////////////////
+inline std::string IsoTimestamp::encode (time_t epoch)
+{
+  std::string out (length, '\0');
+  encode (epoch, out.data ());
+  return out;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Days since 1970-01-01 of the proleptic Gregorian date, see
+// https://howardhinnant.github.io/date_algorithms.html
+constexpr long IsoTimestamp::daysFromCivil (int y, int m, int d)
+{
+  y -= m <= 2;
+  long era = (y >= 0 ? y : y - 399) / 400;
+  long yoe = y - era * 400;
+  long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Inverse of daysFromCivil.
+constexpr void IsoTimestamp::civilFromDays (long days, int& y, int& m, int& d)
+{
+  days += 719468;
+  long era = (days >= 0 ? days : days - 146096) / 146097;
+  long doe = days - era * 146097;
+  long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  long mp  = (5 * doy + 2) / 153;
+
+  d = static_cast <int> (doy - (153 * mp + 2) / 5 + 1);
+  m = static_cast <int> (mp < 10 ? mp + 3 : mp - 9);
+  y = static_cast <int> (yoe + era * 400 + (m <= 2));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+constexpr int IsoTimestamp::daysInMonth (int y, int m)
+{
+  if (m == 2 && y % 4 == 0 && (y % 100 != 0 || y % 400 == 0))
+    return 29;
+
+  return _days_in_month[m - 1];
+}
+
+#endif
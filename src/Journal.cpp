@@ -25,10 +25,21 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <AtomicFile.h>
+#include <FS.h>
 #include <Journal.h>
 #include <TransactionsFactory.h>
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <format.h>
+#include <sstream>
+#include <sys/stat.h>
 #include <timew.h>
+#include <unistd.h>
+
+static const unsigned long SEGMENT_SIZE = 32;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -56,18 +67,22 @@ std::vector <Transaction> loadJournal (AtomicFile& undo)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// The journal at 'location' (undo.data) is stored next to it in segment files
+// undo.<n>.data, with their bounds in undo.segments. A journal in the former
+// single file format is moved into segments when it is first read.
 void Journal::initialize (const std::string& location, int size)
 {
   _location = location;
   _size = size;
 
+  auto extension = _location.rfind (".data");
+  _stem = (extension != std::string::npos && extension == _location.size () - 5) ?
+            _location.substr (0, extension) :
+            _location;
+
   if (! enabled ())
   {
-    AtomicFile undo (_location);
-    if (undo.exists () && undo.size () > 0)
-    {
-      undo.remove ();
-    }
+    clear ();
   }
 }
 
@@ -86,6 +101,8 @@ void Journal::startTransaction ()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// Only the new transaction is written, and old transactions are dropped a
+// whole segment at a time.
 void Journal::endTransaction ()
 {
   if (! enabled ())
@@ -99,33 +116,11 @@ void Journal::endTransaction ()
     throw "Call to end non-existent transaction";
   }
 
-  AtomicFile undo (_location);
-
-  if (_size > 1)
-  {
-    std::vector <Transaction> transactions = loadJournal (undo);
+  loadSegments ();
+  appendTransaction (_currentTransaction->toString ());
+  trim ();
+  saveSegments ();
 
-    unsigned int toCopy = _size - 1;
-    auto it = transactions.cbegin ();
-    auto end = transactions.cend ();
-
-    if (transactions.size () > toCopy)
-    {
-      it += transactions.size () - toCopy;
-    }
-
-    undo.truncate ();
-    for (; it != end; ++it)
-    {
-      undo.append (it->toString ());
-    }
-  }
-  else if (_size == 1)
-  {
-    undo.truncate ();
-  }
-
-  undo.append (_currentTransaction->toString ());
   _currentTransaction.reset ();
 }
 
@@ -136,14 +131,18 @@ void Journal::recordConfigAction (const std::string& before, const std::string&
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void Journal::recordIntervalAction (const std::string&  before, const std::string&  after)
+// Changes to stored intervals, as IntervalDelta entries. Older journals may
+// still hold the JSON based 'interval' action, which undo continues to read.
+void Journal::recordDeltaAction (const std::vector <std::string>& entries)
 {
-  recordUndoAction ("interval", before, after);
+  if (enabled () && _currentTransaction != nullptr)
+  {
+    _currentTransaction->addUndoAction (entries);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Record undoable actions. There are several types:
-//   interval    changes to stored intervals
+// Record undoable actions. Apart from the interval deltas, there is:
 //   config      changes to configuration
 //
 // Actions are only recorded if a transaction is open
@@ -160,6 +159,111 @@ void Journal::recordUndoAction (
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// Returns the offset of the last 'txn:' line in text, which must start at a
+// line boundary. The very start of text only counts if it is also the start
+// of the segment.
+static size_t findTransaction (const std::string& text, bool whole)
+{
+  auto position = text.rfind ("txn:\n");
+  while (position != std::string::npos)
+  {
+    if (position > 0 ? text[position - 1] == '\n' : whole)
+    {
+      return position;
+    }
+
+    if (position == 0)
+    {
+      break;
+    }
+
+    position = text.rfind ("txn:\n", position - 1);
+  }
+
+  return std::string::npos;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Returns the last transaction within the first 'end' bytes of a segment, and
+// sets 'start' to its offset. The segment is read backwards from 'end' a block
+// at a time, so the cost does not depend on the size of the segment.
+static std::string readLastTransaction (const std::string& path, size_t end, size_t& start)
+{
+  int fd = ::open (path.c_str (), O_RDONLY);
+  if (fd == -1)
+  {
+    throw format ("Could not read undo journal segment {1}: {2}", path, strerror (errno));
+  }
+
+  struct stat s;
+  if (::fstat (fd, &s) == -1)
+  {
+    auto error = errno;
+    ::close (fd);
+    throw format ("Could not read undo journal segment {1}: {2}", path, strerror (error));
+  }
+
+  // Transactions written by this process may not be on disk yet.
+  if (static_cast <size_t> (s.st_size) < end)
+  {
+    ::close (fd);
+
+    std::string content;
+    AtomicFile (path).read (content);
+    content.resize (std::min (content.size (), end));
+
+    start = findTransaction (content, true);
+    if (start == std::string::npos)
+    {
+      throw format ("The undo journal segment '{1}' is incomplete.", path);
+    }
+
+    return content.substr (start);
+  }
+
+  const off_t block_size = 4096;
+  std::string tail;
+  off_t offset = end;
+  while (offset > 0)
+  {
+    auto size = std::min (block_size, offset);
+    offset -= size;
+
+    std::string block (size, '\0');
+    for (off_t done = 0; done < size; )
+    {
+      auto count = ::pread (fd, &block[done], size - done, offset + done);
+      if (count <= 0)
+      {
+        auto error = count == 0 ? EIO : errno;
+        if (error == EINTR)
+          continue;
+
+        ::close (fd);
+        throw format ("Could not read undo journal segment {1}: {2}", path, strerror (error));
+      }
+
+      done += count;
+    }
+
+    tail.insert (0, block);
+
+    auto position = findTransaction (tail, offset == 0);
+    if (position != std::string::npos)
+    {
+      ::close (fd);
+      start = offset + position;
+      return tail.substr (position);
+    }
+  }
+
+  ::close (fd);
+  throw format ("The undo journal segment '{1}' is incomplete.", path);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Only the last transaction is read. Removing it just moves the end of the
+// journal back; the bytes are dropped by the next append.
 Transaction Journal::popLastTransaction ()
 {
   if (! enabled ())
@@ -167,34 +271,244 @@ Transaction Journal::popLastTransaction ()
     return Transaction {};
   }
 
-  AtomicFile undo (_location);
-  std::vector <Transaction> transactions = loadJournal (undo);
+  loadSegments ();
 
-  if (transactions.empty ())
+  if (_next == _first)
   {
     return Transaction {};
   }
 
-  Transaction last = transactions.back ();
-  transactions.pop_back ();
+  auto number = (_next - 1) / SEGMENT_SIZE;
+  AtomicFile::rollback (Path (segment (number)));
+
+  size_t start = 0;
+  std::istringstream text (readLastTransaction (segment (number), _tail, start));
+
+  TransactionsFactory factory;
+  std::string line;
+  while (std::getline (text, line))
+  {
+    factory.parseLine (line);
+  }
+
+  auto transactions = factory.get ();
+  if (transactions.size () != 1)
+  {
+    throw format ("The undo journal segment '{1}' is incomplete.", segment (number));
+  }
+
+  --_next;
+
+  if (_next == _first)
+  {
+    AtomicFile (segment (number)).remove ();
+    AtomicFile (_stem + ".segments").remove ();
+    _first = _next = _tail = 0;
+  }
+  else if (_next % SEGMENT_SIZE == 0)
+  {
+    AtomicFile (segment (number)).remove ();
+    _tail = AtomicFile (segment (number - 1)).size ();
+    saveSegments ();
+  }
+  else
+  {
+    _tail = start;
+    saveSegments ();
+  }
+
+  return transactions.front ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string Journal::segment (unsigned long number) const
+{
+  return _stem + '.' + std::to_string (number) + ".data";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reads the segment bounds, once. A journal in the single file format is
+// converted to segments.
+void Journal::loadSegments ()
+{
+  if (_loaded)
+  {
+    return;
+  }
+
+  _loaded = true;
+
+  AtomicFile bounds (_stem + ".segments");
+  if (bounds.exists ())
+  {
+    std::string content;
+    bounds.read (content);
+    bounds.close ();
+
+    std::istringstream in (content);
+    if (! (in >> _first >> _next >> _tail) || _first > _next)
+    {
+      throw format ("Cannot read the undo journal bounds in '{1}'.", bounds.path ());
+    }
+  }
+
+  recoverSegments ();
+
+  AtomicFile legacy (_location);
+  if (legacy.exists ())
+  {
+    for (auto& transaction : loadJournal (legacy))
+    {
+      appendTransaction (transaction.toString ());
+    }
+
+    legacy.remove ();
+    trim ();
+    saveSegments ();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A command interrupted while committing may leave the bounds ahead of the
+// last segment. Only whole transactions are ever written to a segment, so the
+// bounds are moved back to the transactions it does hold.
+void Journal::recoverSegments ()
+{
+  if (_next == _first)
+  {
+    return;
+  }
+
+  auto number = (_next - 1) / SEGMENT_SIZE;
+  AtomicFile::rollback (Path (segment (number)));
+
+  File last (segment (number));
+  std::string content;
+  if (last.exists ())
+  {
+    last.read (content);
+  }
+
+  if (content.size () >= _tail)
+  {
+    return;
+  }
+
+  unsigned long count = 0;
+  for (auto position = content.find ("txn:\n"); position != std::string::npos; position = content.find ("txn:\n", position + 1))
+  {
+    if (position == 0 || content[position - 1] == '\n')
+    {
+      ++count;
+    }
+  }
+
+  debug (format ("Undo journal segment '{1}' holds {2} bytes, not {3}; recovering", last._data, content.size (), _tail));
+
+  _next = std::max (_first, number * SEGMENT_SIZE + count);
+  _tail = count ? content.size () :
+          _next == _first ? 0 :
+          File (segment ((_next - 1) / SEGMENT_SIZE)).size ();
 
-  if (transactions.empty ())
+  saveSegments ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Journal::saveSegments ()
+{
+  AtomicFile::write (_stem + ".segments", format ("{1} {2} {3}\n", _first, _next, _tail));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Appends to the last segment in place, or starts a new one. Anything found
+// after the end of the journal belongs to undone transactions, or was left by
+// an interrupted command. As the bounds already exclude it, it can be cut off
+// before the bounds are updated.
+void Journal::appendTransaction (const std::string& transaction)
+{
+  auto path = segment (_next / SEGMENT_SIZE);
+  AtomicFile::rollback (Path (path));
+
+  if (_next % SEGMENT_SIZE == 0)
   {
-    undo.close ();
-    undo.remove ();
+    AtomicFile file (path);
+    file.truncate ();
+    file.append (transaction);
+    _tail = transaction.size ();
   }
   else
   {
-    undo.open ();
-    undo.truncate ();
+    if (File (path).size () > _tail &&
+        ::truncate (path.c_str (), _tail) == -1)
+    {
+      throw format ("Could not truncate undo journal segment {1}: {2}", path, strerror (errno));
+    }
 
-    for (auto& transaction : transactions)
+    AtomicFile file (path);
+    if (file.size () != _tail)
     {
-      undo.append (transaction.toString ());
+      throw format ("The undo journal segment '{1}' is incomplete.", path);
     }
 
-    undo.close ();
+    file.append_in_place (transaction);
+    _tail += transaction.size ();
   }
 
-  return last;
+  ++_next;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// Keeps the last journal.size transactions. Segments holding only older ones
+// are removed.
+void Journal::trim ()
+{
+  if (_size < 0 || _next - _first <= static_cast <unsigned long> (_size))
+  {
+    return;
+  }
+
+  auto first = _next - _size;
+  for (auto number = _first / SEGMENT_SIZE; number < first / SEGMENT_SIZE; ++number)
+  {
+    AtomicFile (segment (number)).remove ();
+  }
+
+  _first = first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Removes the journal, in either format.
+void Journal::clear ()
+{
+  AtomicFile bounds (_stem + ".segments");
+  if (bounds.exists ())
+  {
+    std::string content;
+    bounds.read (content);
+    bounds.close ();
+
+    std::istringstream in (content);
+    unsigned long first = 0;
+    unsigned long next = 0;
+    if (in >> first >> next && first < next)
+    {
+      for (auto number = first / SEGMENT_SIZE; number <= (next - 1) / SEGMENT_SIZE; ++number)
+      {
+        AtomicFile (segment (number)).remove ();
+      }
+    }
+
+    bounds.remove ();
+  }
+
+  AtomicFile legacy (_location);
+  if (legacy.exists () && legacy.size () > 0)
+  {
+    legacy.remove ();
+  }
+
+  _loaded = true;
+  _first = _next = _tail = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
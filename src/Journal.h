@@ -45,7 +45,7 @@ public:
   void startTransaction ();
   void endTransaction ();
   void recordConfigAction(const std::string&, const std::string&);
-  void recordIntervalAction(const std::string&, const std::string&);
+  void recordDeltaAction(const std::vector <std::string>&);
   bool enabled () const;
 
   Transaction popLastTransaction();
@@ -53,9 +53,27 @@ public:
 private:
   void recordUndoAction (const std::string&, const std::string&, const std::string&);
 
+  std::string segment (unsigned long) const;
+  void loadSegments ();
+  void recoverSegments ();
+  void saveSegments ();
+  void appendTransaction (const std::string&);
+  void trim ();
+  void clear ();
+
   std::string _location {};
+  std::string _stem {};
   std::shared_ptr <Transaction> _currentTransaction = nullptr;
   int _size {0};
+
+  // The journal is kept in segment files of SEGMENT_SIZE transactions each.
+  // Transaction n is stored in segment n / SEGMENT_SIZE, and the transactions
+  // from _first up to, but excluding, _next are available for undo. _tail is
+  // the size in bytes of the last segment.
+  bool _loaded {false};
+  unsigned long _first {0};
+  unsigned long _next {0};
+  size_t _tail {0};
 };
 
 #endif
@@ -0,0 +1,232 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <RangeSet.h>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+// An open range ends after every closed one.
+static const time_t OPEN = std::numeric_limits <time_t>::max ();
+
+////////////////////////////////////////////////////////////////////////////////
+static time_t startOf (const Range& range)
+{
+  return range.start.toEpoch ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static time_t endOf (const Range& range)
+{
+  return range.is_ended () ? range.end.toEpoch () : OPEN;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+RangeSet::RangeSet (const Range& range)
+{
+  if (startOf (range) < endOf (range))
+  {
+    _ranges.push_back (range);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+RangeSet::RangeSet (std::vector <Range> ranges) : _ranges (std::move (ranges))
+{
+  _ranges.erase (std::remove_if (_ranges.begin (), _ranges.end (), [] (const Range& range) { return startOf (range) >= endOf (range); }),
+                 _ranges.end ());
+
+  auto byStart = [] (const Range& left, const Range& right) { return startOf (left) < startOf (right); };
+  if (! std::is_sorted (_ranges.begin (), _ranges.end (), byStart))
+  {
+    std::sort (_ranges.begin (), _ranges.end (), byStart);
+  }
+
+  normalize ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Combines overlapping ranges, which must be sorted by start. Ranges that only
+// touch are kept apart, as merge always did: flatten only removes exclusions
+// an interval encloses, and joining an evening to the following night would
+// make a block that an interval started in the evening no longer encloses.
+void RangeSet::normalize ()
+{
+  size_t cursor = 0;
+  for (size_t i = 0; i < _ranges.size (); ++i)
+  {
+    if (cursor && startOf (_ranges[i]) < endOf (_ranges[cursor - 1]))
+    {
+      if (endOf (_ranges[i]) > endOf (_ranges[cursor - 1]))
+      {
+        _ranges[cursor - 1].end = _ranges[i].end;
+      }
+    }
+    else
+    {
+      if (cursor != i)
+      {
+        _ranges[cursor] = std::move (_ranges[i]);
+      }
+
+      ++cursor;
+    }
+  }
+
+  _ranges.resize (cursor);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+RangeSet RangeSet::unite (const RangeSet& other) const
+{
+  RangeSet result;
+  result._ranges.reserve (_ranges.size () + other._ranges.size ());
+  std::merge (_ranges.begin (), _ranges.end (),
+              other._ranges.begin (), other._ranges.end (),
+              std::back_inserter (result._ranges),
+              [] (const Range& left, const Range& right) { return startOf (left) < startOf (right); });
+
+  result.normalize ();
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+RangeSet RangeSet::intersect (const RangeSet& other) const
+{
+  RangeSet result;
+
+  auto left = _ranges.begin ();
+  auto right = other._ranges.begin ();
+  while (left != _ranges.end () && right != other._ranges.end ())
+  {
+    const auto& start = startOf (*left) < startOf (*right) ? right->start : left->start;
+    const auto& end = endOf (*left) < endOf (*right) ? left->end : right->end;
+
+    if (start.toEpoch () < (end.toEpoch () ? end.toEpoch () : OPEN))
+    {
+      result._ranges.emplace_back (start, end);
+    }
+
+    if (endOf (*left) < endOf (*right))
+    {
+      ++left;
+    }
+    else
+    {
+      ++right;
+    }
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+RangeSet RangeSet::subtract (const RangeSet& other) const
+{
+  RangeSet result;
+
+  auto subtraction = other._ranges.begin ();
+  for (auto& range : _ranges)
+  {
+    // What remains of range starts at 'start', or 'from' as a time.
+    Datetime start = range.start;
+    time_t from = startOf (range);
+    const time_t to = endOf (range);
+
+    while (subtraction != other._ranges.end () && endOf (*subtraction) <= from)
+    {
+      ++subtraction;
+    }
+
+    // A subtraction reaching past this range may also cut the next one, so it
+    // is not passed over.
+    for (; subtraction != other._ranges.end () && startOf (*subtraction) < to; ++subtraction)
+    {
+      if (startOf (*subtraction) > from)
+      {
+        result._ranges.emplace_back (start, subtraction->start);
+      }
+
+      if (endOf (*subtraction) >= to)
+      {
+        from = to;
+        break;
+      }
+
+      start = subtraction->end;
+      from = endOf (*subtraction);
+    }
+
+    if (from < to)
+    {
+      result._ranges.emplace_back (start, range.end);
+    }
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool RangeSet::empty () const
+{
+  return _ranges.empty ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+size_t RangeSet::size () const
+{
+  return _ranges.size ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+RangeSet::const_iterator RangeSet::begin () const
+{
+  return _ranges.begin ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+RangeSet::const_iterator RangeSet::end () const
+{
+  return _ranges.end ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The first range that ends after the given time.
+RangeSet::const_iterator RangeSet::lower_bound (const Datetime& time) const
+{
+  return std::partition_point (_ranges.begin (), _ranges.end (), [&time] (const Range& range) { return endOf (range) <= time.toEpoch (); });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Hands the ranges over, leaving the set empty.
+std::vector <Range> RangeSet::release ()
+{
+  std::vector <Range> ranges;
+  ranges.swap (_ranges);
+  return ranges;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_RANGESET
+#define INCLUDED_RANGESET
+
+#include <Range.h>
+#include <vector>
+
+// A set of points in time, held as sorted, disjoint, non-empty ranges, where
+// one range may end where the next starts. Only the last range may be open.
+// The set operations walk both sets once, side by side.
+class RangeSet
+{
+public:
+  using const_iterator = std::vector <Range>::const_iterator;
+
+  RangeSet () = default;
+  explicit RangeSet (const Range&);
+  explicit RangeSet (std::vector <Range>);
+
+  RangeSet unite (const RangeSet&) const;
+  RangeSet intersect (const RangeSet&) const;
+  RangeSet subtract (const RangeSet&) const;
+
+  bool empty () const;
+  size_t size () const;
+  const_iterator begin () const;
+  const_iterator end () const;
+  const_iterator lower_bound (const Datetime&) const;
+
+  std::vector <Range> release ();
+
+private:
+  void normalize ();
+
+private:
+  std::vector <Range> _ranges {};
+};
+
+#endif
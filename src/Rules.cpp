@@ -27,11 +27,15 @@
 #include <AtomicFile.h>
 #include <FS.h>
 #include <JSON.h>
+#include <Datetime.h>
 #include <Rules.h>
+#include <algorithm>
 #include <cassert>
 #include <cerrno>
+#include <cctype>
 #include <cinttypes>
 #include <format.h>
+#include <iomanip>
 #include <shared.h>
 #include <sstream>
 #include <tuple>
@@ -44,6 +48,8 @@ Rules::Rules ()
   {
     {"confirmation",             "on"},
     {"debug",                    "off"},
+    {"debug.parser",             "off"},
+    {"durability",               "none"},
     {"verbose",                  "on"},
 
     // 'day' report.
@@ -220,18 +226,21 @@ bool Rules::getBoolean (const std::string& key, bool defaultValue) const
 void Rules::set (const std::string& key, const int value)
 {
   _settings[key] = format (value);
+  changed (key);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Rules::set (const std::string& key, const double value)
 {
   _settings[key] = format (value, 1, 8);
+  changed (key);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Rules::set (const std::string& key, const std::string& value)
 {
   _settings[key] = value;
+  changed (key);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -247,6 +256,100 @@ std::vector <std::string> Rules::all (const std::string& stem) const
   return items;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// The holidays are rules named 'holidays.<locale>.<date>', which sort together,
+// so only their part of the settings is visited.
+const HolidayTable& Rules::holidays () const
+{
+  if (! _holidays)
+  {
+    const std::string stem = "holidays.";
+
+    std::vector <HolidayTable::Holiday> holidays;
+    for (auto it = _settings.lower_bound (stem);
+         it != _settings.end () && it->first.compare (0, stem.length (), stem) == 0;
+         ++it)
+    {
+      auto first_dot = it->first.find ('.');
+      auto last_dot = it->first.rfind ('.');
+
+      holidays.push_back ({Datetime (it->first.substr (last_dot + 1), "Y_M_D"),
+                           it->first.substr (first_dot + 1, last_dot - first_dot - 1),
+                           it->second});
+    }
+
+    _holidays = std::make_shared <HolidayTable> (std::move (holidays));
+  }
+
+  return *_holidays;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Whether the day of an 'exclusions.days.<day>' rule is a date in the
+// 'YYYY_MM_DD' form, rather than one relative to today, such as 'monday'.
+static bool isAbsoluteDay (const std::string& day)
+{
+  if (day.length () != 10 || day[4] != '_' || day[7] != '_')
+    return false;
+
+  for (auto i : {0, 1, 2, 3, 5, 6, 8, 9})
+    if (! isdigit (day[i]))
+      return false;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A 64-bit FNV-1a hash of the 'holidays.*' and 'exclusions.*' rules. The local
+// time of a winter and a summer date is included as well, because the ranges
+// are local times, and change with the time zone. So is the date that a
+// relative day exclusion currently stands for.
+const std::string& Rules::exclusionFingerprint () const
+{
+  if (! _exclusionFingerprint.empty ())
+    return _exclusionFingerprint;
+
+  uint64_t hash = 14695981039346656037ULL;
+  auto add = [&hash] (const std::string& text)
+  {
+    for (unsigned char c : text)
+    {
+      hash ^= c;
+      hash *= 1099511628211ULL;
+    }
+
+    // Terminate each string, so that 'ab' 'c' and 'a' 'bc' differ.
+    hash *= 1099511628211ULL;
+  };
+
+  for (auto& stem : {"holidays.", "exclusions."})
+  {
+    for (auto& name : all (stem))
+    {
+      add (name);
+      add (get (name));
+
+      if (name.compare (0, 16, "exclusions.days.") == 0)
+      {
+        auto day = lowerCase (name.substr (16));
+        if (! isAbsoluteDay (day))
+        {
+          std::replace (day.begin (), day.end (), '_', '-');
+          add (std::to_string (Datetime (day).toEpoch ()));
+        }
+      }
+    }
+  }
+
+  add (std::to_string (Datetime (2000, 1, 1, 0, 0, 0).toEpoch ()));
+  add (std::to_string (Datetime (2000, 7, 1, 0, 0, 0).toEpoch ()));
+
+  std::stringstream out;
+  out << std::hex << std::setw (16) << std::setfill ('0') << hash;
+  _exclusionFingerprint = out.str ();
+  return _exclusionFingerprint;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool Rules::isRuleType (const std::string& type) const
 {
@@ -464,6 +567,17 @@ void Rules::parseRuleSettings (
     throw std::string ("Syntax error - indentation is not right.");
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void Rules::changed (const std::string& key)
+{
+  if (key.compare (0, 9, "holidays.") == 0)
+    _holidays.reset ();
+
+  if (key.compare (0, 9, "holidays.") == 0 ||
+      key.compare (0, 11, "exclusions.") == 0)
+    _exclusionFingerprint.clear ();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 unsigned int Rules::getIndentation (const std::string& line)
 {
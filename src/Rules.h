@@ -28,9 +28,11 @@
 #define INCLUDED_RULES
 
 #include <Database.h>
+#include <HolidayTable.h>
 #include <Journal.h>
 #include <Lexer.h>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -52,6 +54,8 @@ public:
   void set (const std::string&, const std::string&);
 
   std::vector <std::string> all (const std::string& = "") const;
+  const HolidayTable& holidays () const;
+  const std::string& exclusionFingerprint () const;
   bool isRuleType (const std::string&) const;
 
   std::string dump () const;
@@ -63,6 +67,7 @@ private:
   void parse               (const std::string&, int = 1);
   void parseRule           (const std::string&);
   void parseRuleSettings   (const std::vector <std::string>&);
+  void changed             (const std::string&);
 
   unsigned int getIndentation (const std::string&);
   std::vector <std::string> tokenizeLine (const std::string&);
@@ -73,6 +78,13 @@ private:
   std::map <std::string, std::string> _settings      {};
   std::vector <std::string>           _rule_types    {"tags", "reports", "theme", "holidays", "exclusions"};
 
+  // Compiled from the 'holidays.*' settings on first use after they change.
+  mutable std::shared_ptr <HolidayTable> _holidays {};
+
+  // Hashed from the 'holidays.*' and 'exclusions.*' settings on first use
+  // after they change.
+  mutable std::string _exclusionFingerprint {};
+
 };
 
 #endif
@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <TagDictionary.h>
+#include <format.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Returns the id of the tag, adding it if it is new.
+TagDictionary::Id TagDictionary::intern (const std::string& tag)
+{
+  auto& dictionary = instance ();
+
+  auto [entry, added] = dictionary._ids.emplace (tag, dictionary._names.size ());
+  if (added)
+  {
+    // Keys of an unordered_map do not move when it grows.
+    dictionary._names.push_back (&entry->first);
+  }
+
+  return entry->second;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Looks up the id of the tag without adding it. A tag without an id is not
+// on any interval.
+bool TagDictionary::find (const std::string& tag, Id& id)
+{
+  auto& dictionary = instance ();
+
+  auto entry = dictionary._ids.find (tag);
+  if (entry == dictionary._ids.end ())
+  {
+    return false;
+  }
+
+  id = entry->second;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const std::string& TagDictionary::name (Id id)
+{
+  auto& dictionary = instance ();
+
+  if (id >= dictionary._names.size ())
+  {
+    throw format ("Unknown tag id {1}", id);
+  }
+
+  return *dictionary._names[id];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Orders ids by the names of their tags, which is the order tags are written
+// in.
+bool TagDictionary::less (Id left, Id right)
+{
+  auto& names = instance ()._names;
+  return left != right && *names[left] < *names[right];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t TagDictionary::size ()
+{
+  return instance ()._names.size ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TagDictionary& TagDictionary::instance ()
+{
+  static TagDictionary dictionary;
+  return dictionary;
+}
+
+////////////////////////////////////////////////////////////////////////////////
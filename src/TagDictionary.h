@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_TAGDICTIONARY
+#define INCLUDED_TAGDICTIONARY
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Process-wide mapping between tag names and small integer ids. Ids are
+// assigned in order of first use and never reused, so equal ids mean equal
+// names. The tags known to the TagInfoDatabase are added first, when it is
+// loaded.
+class TagDictionary
+{
+public:
+  using Id = uint32_t;
+
+  static Id intern (const std::string&);
+  static bool find (const std::string&, Id&);
+  static const std::string& name (Id);
+  static bool less (Id, Id);
+  static std::size_t size ();
+
+private:
+  static TagDictionary& instance ();
+
+  std::unordered_map <std::string, Id> _ids   {};
+  std::vector <const std::string*>     _names {};
+};
+
+#endif
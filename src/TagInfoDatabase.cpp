@@ -26,6 +26,7 @@
 
 #include <JSON.h>
 #include <TagInfo.h>
+#include <TagDictionary.h>
 #include <TagInfoDatabase.h>
 #include <format.h>
 #include <timew.h>
@@ -74,6 +75,7 @@ int TagInfoDatabase::decrementTag (const std::string& tag)
 //
 void TagInfoDatabase::add (const std::string& tag, const TagInfo& tagInfo)
 {
+  TagDictionary::intern (tag);
   _is_modified = true;
   _tagInformation.emplace (tag, tagInfo);
 }
@@ -34,6 +34,11 @@ void Transaction::addUndoAction (
    _actions.emplace_back (type, before, after);
 }
 
+void Transaction::addUndoAction (const std::vector <std::string>& entries)
+{
+   _actions.emplace_back (entries);
+}
+
 std::vector <UndoAction> Transaction::getActions () const
 {
   return _actions;
@@ -34,6 +34,7 @@ class Transaction
 {
 public:
   void addUndoAction(const std::string&, const std::string&, const std::string&);
+  void addUndoAction(const std::vector <std::string>&);
 
   std::string toString() const;
 
@@ -25,16 +25,38 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <TransactionsFactory.h>
+#include <format.h>
 #include <vector>
 
 void TransactionsFactory::parseLine (const std::string& line)
 {
   if (! line.compare (0, 4, "txn:"))
   {
+    flushDelta ();
     _transactions.emplace_back ();
   }
+  else if (! line.compare (0, 8, "  delta:"))
+  {
+    flushDelta ();
+
+    auto version = line.substr (9, line.size ());
+    if (version != "1")
+    {
+      throw format ("Unsupported undo record version '{1}'", version);
+    }
+
+    _delta = true;
+  }
+  else if (_delta && line.size () > 4 && line[3] == ' ' &&
+           (! line.compare (0, 3, "  +") ||
+            ! line.compare (0, 3, "  -") ||
+            ! line.compare (0, 3, "  ~")))
+  {
+    _entries.push_back (line.substr (2, line.size ()));
+  }
   else if (! line.compare (0, 7, "  type:"))
   {
+    flushDelta ();
     _type = line.substr (8, line.size ());
   }
   else if (! line.compare (0, 9, "  before:"))
@@ -54,5 +76,16 @@ void TransactionsFactory::parseLine (const std::string& line)
 
 std::vector <Transaction> TransactionsFactory::get ()
 {
+  flushDelta ();
   return _transactions;
 }
+
+void TransactionsFactory::flushDelta ()
+{
+  if (_delta)
+  {
+    _transactions.back ().addUndoAction (_entries);
+    _entries.clear ();
+    _delta = false;
+  }
+}
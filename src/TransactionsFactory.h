@@ -38,9 +38,13 @@ public:
   std::vector< Transaction > get();
 
 private:
+  void flushDelta();
+
   std::string _type;
   std::string _before;
   std::string _after;
+  bool _delta {false};
+  std::vector< std::string > _entries {};
 
   std::vector< Transaction > _transactions {};
 };
@@ -31,8 +31,24 @@ UndoAction::UndoAction (std::string type, std::string before, std::string after)
   _type (std::move (type)), _before (std::move (before)), _after (std::move (after))
 {}
 
+// A 'delta' action holds IntervalDelta entries instead of a before and after.
+UndoAction::UndoAction (std::vector <std::string> entries) :
+  _type ("delta"), _entries (std::move (entries))
+{}
+
 std::string UndoAction::toString () const
 {
+  if (_type == "delta")
+  {
+    std::string output = "  delta: 1\n";
+    for (auto& entry : _entries)
+    {
+      output += "  " + entry + "\n";
+    }
+
+    return output;
+  }
+
   return "  type: " + _type + "\n" +
          "  before: " + _before + "\n" +
          "  after: " + _after + "\n";
@@ -53,4 +69,7 @@ std::string UndoAction::getAfter () const
   return _after;
 }
 
-
+const std::vector <std::string>& UndoAction::getEntries () const
+{
+  return _entries;
+}
@@ -28,15 +28,18 @@
 #define INCLUDED_UNDOACTION
 
 #include <string>
+#include <vector>
 
 class UndoAction
 {
 public:
   UndoAction(std::string, std::string, std::string);
+  explicit UndoAction(std::vector <std::string>);
 
   std::string getType() const;
   std::string getBefore() const;
   std::string getAfter() const;
+  const std::vector <std::string>& getEntries() const;
 
   std::string toString () const;
 
@@ -44,6 +47,7 @@ private:
   const std::string _type;
   const std::string _before;
   const std::string _after;
+  const std::vector <std::string> _entries {};
 };
 
 #endif
@@ -90,22 +90,28 @@ int CmdAnnotate (
   }
 
   // Apply annotation to intervals.
+  std::vector <Interval> modified;
+  modified.reserve (intervals.size ());
+
   for (const auto& interval : intervals)
   {
-    Interval modified {interval};
-    modified.setAnnotation (annotation);
+    modified.push_back (interval);
+    modified.back ().setAnnotation (annotation);
+  }
 
-    database.modifyInterval (interval, modified, verbose);
+  database.modifyIntervals (intervals, modified, verbose);
 
-    if (verbose)
+  if (verbose)
+  {
+    for (const auto& interval : modified)
     {
       if (annotation.empty ())
       {
-        std::cout << "Removed annotation from @" << modified.id << std::endl;
+        std::cout << "Removed annotation from @" << interval.id << std::endl;
       }
       else
       {
-        std::cout << "Annotated @" << modified.id << " with \"" << annotation << "\"" << std::endl;
+        std::cout << "Annotated @" << interval.id << " with \"" << annotation << "\"" << std::endl;
       }
     }
   }
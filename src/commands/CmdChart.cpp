@@ -38,8 +38,6 @@
 
 int renderChart (const std::string&, const CLI&, Rules&, Database&);
 
-std::map <Datetime, std::string> createHolidayMap (Rules&, Range&);
-
 ////////////////////////////////////////////////////////////////////////////////
 int CmdChartDay (
   const CLI& cli,
@@ -119,8 +117,7 @@ int renderChart (
     return 0;
   }
 
-  const auto exclusions = getAllExclusions (rules, range);
-  const auto holidays = createHolidayMap (rules, range);
+  const RangeSet exclusions (getAllExclusions (rules, range));
 
   // Map tags to colors.
   auto palette = createPalette (rules);
@@ -164,42 +161,9 @@ int renderChart (
 
   Chart chart (configuration);
 
-  std::cout << chart.render (range, tracked, exclusions, holidays);
+  std::cout << chart.render (range, tracked, exclusions, rules.holidays ());
 
   return 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-std::map <Datetime, std::string> createHolidayMap (Rules& rules, Range& range)
-{
-  std::map <Datetime, std::string> mapping;
-  auto holidays = rules.all ("holidays.");
-
-  for (auto& entry : holidays)
-  {
-    auto first_dot = entry.find ('.');
-    auto last_dot = entry.rfind ('.');
-
-    if (last_dot != std::string::npos)
-    {
-      auto date = entry.substr (last_dot + 1);
-      std::replace (date.begin (), date.end (), '_', '-');
-      Datetime holiday (date);
-
-      if (holiday >= range.start && holiday <= range.end)
-      {
-        std::stringstream out;
-        out << " ["
-            << entry.substr (first_dot + 1, last_dot - first_dot - 1)
-            << "] "
-            << rules.get (entry);
-        auto locale = entry.substr (first_dot + 1, last_dot - first_dot - 1);
-        mapping[holiday] = out.str ();
-      }
-    }
-  }
-
-  return mapping;
-}
-
-////////////////////////////////////////////////////////////////////////////////
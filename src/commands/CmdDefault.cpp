@@ -24,8 +24,6 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <IntervalFilterAllInRange.h>
-#include <IntervalFilterFirstOf.h>
 #include <commands.h>
 #include <iostream>
 #include <timew.h>
@@ -37,14 +35,13 @@ int CmdDefault (Rules& rules, Database& database)
   const bool verbose = rules.getBoolean ("verbose");
 
   // Load the most recent interval, summarize and display.
-  IntervalFilterFirstOf filtering (std::make_shared <IntervalFilterAllInRange> (Range {}));
-  auto latest = getTracked (database, rules, filtering);
+  auto latest = getLatestTracked (database, rules);
 
-  if (! latest.empty () && latest.at (0).is_open ())
+  if (latest.is_open ())
   {
     if (verbose)
     {
-      std::cout << intervalSummarize (rules, latest.at (0));
+      std::cout << intervalSummarize (rules, latest);
     }
 
     return 0;
@@ -73,11 +73,11 @@ int CmdDelete (
     }
   }
 
-  for (const auto& interval : intervals)
-  {
-    database.deleteInterval (interval);
+  database.modifyIntervals (intervals, {}, verbose);
 
-    if (verbose)
+  if (verbose)
+  {
+    for (const auto& interval : intervals)
     {
       std::cout << "Deleted @" << interval.id << '\n';
     }
@@ -65,9 +65,28 @@ int CmdExport (
     );
   }
 
-  auto intervals = getTracked (database, rules, *filtering);
+  // Write the intervals as they are read, rather than building the whole
+  // document first. The output is the same as jsonFromIntervals ().
+  int counter = 0;
+  std::cout << "[\n";
 
-  std::cout << jsonFromIntervals (intervals);
+  forEachTracked (database, rules, *filtering, TrackedOrder::chronological, [&counter] (const Interval& interval)
+  {
+    if (counter++)
+    {
+      std::cout << ",\n";
+    }
+
+    std::cout << interval.json ();
+    return true;
+  });
+
+  if (counter)
+  {
+    std::cout << '\n';
+  }
+
+  std::cout << "]\n";
 
   return 0;
 }
@@ -49,6 +49,7 @@ int CmdHelpUsage (const Extensions& extensions)
             << "       timew gaps [<interval>] [<tag> ...]\n"
             << "       timew get <DOM> [<DOM> ...]\n"
             << "       timew help [<command> | " << join ( " | ", timew_help_concepts) << "]\n"
+            << "       timew import\n"
             << "       timew join @<id> @<id>\n"
             << "       timew lengthen @<id> [@<id> ...] <duration>\n"
             << "       timew modify (start|end) @<id> <date>\n"
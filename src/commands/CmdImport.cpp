@@ -0,0 +1,298 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <IntervalFactory.h>
+#include <IntervalFilterAllInRange.h>
+#include <algorithm>
+#include <cctype>
+#include <commands.h>
+#include <format.h>
+#include <functional>
+#include <iostream>
+#include <timew.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// The objects of a JSON array, such as the one written by 'timew export', are
+// collected one at a time, however the input is split into lines.
+struct JsonObjects
+{
+  std::string object  {};
+  int         line    {0};
+  int         depth   {0};
+  bool        quoted  {false};
+  bool        escaped {false};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Scans a line of JSON input, and passes each object it completes to the
+// visitor, along with the number of the line the object started on. Outside of
+// the objects, only the array brackets, commas and whitespace are accepted.
+static void scanJson (
+  JsonObjects& objects,
+  const std::string& input,
+  int number,
+  const std::function <void (int, const std::string&)>& visitor)
+{
+  for (auto c : input)
+  {
+    if (objects.depth == 0)
+    {
+      if (c == '{')
+      {
+        objects.object = c;
+        objects.line = number;
+        objects.depth = 1;
+      }
+      else if (c != '[' && c != ']' && c != ',' && ! isspace (static_cast <unsigned char> (c)))
+      {
+        throw format ("Could not import line {1}: expected a JSON object.", number);
+      }
+
+      continue;
+    }
+
+    objects.object += c;
+
+    if (objects.escaped)
+    {
+      objects.escaped = false;
+    }
+    else if (objects.quoted)
+    {
+      objects.escaped = c == '\\';
+      objects.quoted = c != '"';
+    }
+    else if (c == '"')
+    {
+      objects.quoted = true;
+    }
+    else if (c == '{')
+    {
+      ++objects.depth;
+    }
+    else if (c == '}' && --objects.depth == 0)
+    {
+      visitor (objects.line, objects.object);
+    }
+  }
+
+  if (objects.depth > 0)
+  {
+    objects.object += '\n';
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Sort the intervals by start, then sweep them while tracking the interval that
+// reaches furthest. Any interval starting before that reach overlaps it. Only
+// overlaps involving an imported interval are reported.
+static void checkOverlaps (std::vector <std::pair <Interval, bool>>& intervals)
+{
+  std::stable_sort (intervals.begin (), intervals.end (), [] (const std::pair <Interval, bool>& a, const std::pair <Interval, bool>& b)
+  {
+    return a.first.start < b.first.start;
+  });
+
+  const std::pair <Interval, bool>* reach = nullptr;
+  for (auto& current : intervals)
+  {
+    if (reach != nullptr &&
+        (reach->first.is_open () || current.first.start < reach->first.end) &&
+        (reach->second || current.second))
+    {
+      debug ("Input         " + current.first.dump ());
+      debug ("Overlaps with " + reach->first.dump ());
+      throw format ("Cannot import {1}, as it overlaps with {2}.",
+                    current.first.serialize (),
+                    reach->first.serialize ());
+    }
+
+    if (reach == nullptr ||
+        current.first.is_open () ||
+        (! reach->first.is_open () && current.first.end > reach->first.end))
+    {
+      reach = &current;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CmdImport (
+  const CLI& cli,
+  Rules& rules,
+  Database& database,
+  Journal& journal)
+{
+  const bool verbose = rules.getBoolean ("verbose");
+
+  if (! cli.getWords ().empty () || ! cli.getIds ().empty ())
+  {
+    throw std::string ("The import command reads from standard input, and accepts no arguments. See 'timew help import'.");
+  }
+
+  // Read all records first. The format is decided by the first non-blank
+  // character: JSON as written by 'timew export', or data file lines.
+  std::vector <Interval> imported;
+  Datetime earliest;
+  Datetime latest;
+  bool open = false;
+
+  auto add = [&] (Interval& interval, int number)
+  {
+    if (! interval.is_started ())
+    {
+      throw format ("Could not import line {1}: the interval has no start.", number);
+    }
+
+    if (interval.is_ended () && interval.end < interval.start)
+    {
+      throw format ("Could not import line {1}: the interval ends before it starts.", number);
+    }
+
+    interval.id = 0;
+
+    if (imported.empty () || interval.start < earliest)
+    {
+      earliest = interval.start;
+    }
+
+    if (interval.is_open ())
+    {
+      open = true;
+    }
+    else if (imported.empty () || interval.end > latest)
+    {
+      latest = interval.end;
+    }
+
+    imported.push_back (interval);
+  };
+
+  auto addJson = [&add] (int number, const std::string& object)
+  {
+    Interval interval;
+    try
+    {
+      interval = IntervalFactory::fromJson (object);
+    }
+    catch (const std::string& error)
+    {
+      throw format ("Could not import line {1}: {2}", number, error);
+    }
+
+    add (interval, number);
+  };
+
+  bool json = false;
+  bool detected = false;
+  JsonObjects objects;
+  int number = 0;
+
+  std::string line;
+  while (std::getline (std::cin, line))
+  {
+    ++number;
+
+    auto first = line.find_first_not_of (" \t\r");
+    if (! detected)
+    {
+      if (first == std::string::npos)
+      {
+        continue;
+      }
+
+      json = line[first] == '[' || line[first] == '{';
+      detected = true;
+    }
+
+    if (json)
+    {
+      scanJson (objects, line, number, addJson);
+    }
+    else if (first != std::string::npos)
+    {
+      auto last = line.find_last_not_of (" \t\r");
+
+      Interval interval;
+      try
+      {
+        interval = IntervalFactory::fromSerialization (line.substr (first, last - first + 1));
+      }
+      catch (const std::string& error)
+      {
+        throw format ("Could not import line {1}: {2}", number, error);
+      }
+
+      add (interval, number);
+    }
+  }
+
+  if (objects.depth > 0)
+  {
+    throw format ("Could not import line {1}: the JSON object is incomplete.", objects.line);
+  }
+
+  if (imported.empty ())
+  {
+    if (verbose)
+    {
+      std::cout << "Nothing to import.\n";
+    }
+
+    return 0;
+  }
+
+  // The stored intervals in the imported range are read in one pass, and
+  // checked together with the imported ones.
+  std::vector <std::pair <Interval, bool>> all;
+  all.reserve (imported.size ());
+  for (auto& interval : imported)
+  {
+    all.emplace_back (interval, true);
+  }
+
+  IntervalFilterAllInRange filtering ({earliest, open ? Datetime (0) : latest});
+  forEachTracked (database, rules, filtering, TrackedOrder::chronological, [&all] (const Interval& interval)
+  {
+    all.emplace_back (interval, false);
+    return true;
+  });
+
+  checkOverlaps (all);
+
+  journal.startTransaction ();
+  database.modifyIntervals ({}, imported, verbose);
+  journal.endTransaction ();
+
+  if (verbose)
+  {
+    std::cout << "Imported " << imported.size () << (imported.size () == 1 ? " interval.\n" : " intervals.\n");
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -77,6 +77,8 @@ int CmdLengthen (
   }
 
   // Lengthen intervals specified by ids
+  Database::Batch batch (database);
+
   for (auto& interval : intervals)
   {
     if (interval.is_open ())
@@ -96,6 +98,7 @@ int CmdLengthen (
     }
   }
 
+  batch.end ();
   journal.endTransaction ();
 
   return 0;
@@ -75,6 +75,8 @@ int CmdResize (
     }
   }
 
+  Database::Batch batch (database);
+
   for (auto& interval : intervals)
   {
     if (interval.is_open ())
@@ -94,6 +96,7 @@ int CmdResize (
     }
   }
 
+  batch.end ();
   journal.endTransaction ();
 
   return 0;
@@ -99,20 +99,21 @@ int CmdRetag (
   }
 
   // Remove old tags and apply new tags to intervals.
+  std::vector <Interval> modified;
+  modified.reserve (intervals.size ());
+
   for (const auto& interval : intervals)
   {
-    Interval modified {interval};
-
-    modified.clearTags ();
-
-    for (auto& tag : tags)
-    {
-      modified.tag (tag);
-    }
+    modified.push_back (interval);
+    modified.back ().clearTags ();
+    modified.back ().tag (tags);
+  }
 
-    database.modifyInterval (interval, modified, verbose);
+  database.modifyIntervals (intervals, modified, verbose);
 
-    if (verbose)
+  if (verbose)
+  {
+    for (const auto& interval : intervals)
     {
       std::cout << "Retagged @" << interval.id << " as " << joinQuotedIfNeeded (" ", tags) << '\n';
     }
@@ -77,6 +77,8 @@ int CmdShorten (
   }
 
   // Shorten intervals specified by ids
+  Database::Batch batch (database);
+
   for (auto& interval : intervals)
   {
     if (interval.is_open ())
@@ -103,6 +105,7 @@ int CmdShorten (
     }
   }
 
+  batch.end ();
   journal.endTransaction ();
 
   return 0;
@@ -78,21 +78,22 @@ int CmdStop (
   }
 
   auto tags = cli.getTags ();
+  auto latestTags = latest.tags ();
 
   std::set <std::string> diff = {};
 
-  if(! std::includes(latest.tags ().begin (), latest.tags ().end (),
+  if(! std::includes(latestTags.begin (), latestTags.end (),
                      tags.begin (), tags.end ()))
   {
     std::set_difference(tags.begin (), tags.end (),
-                        latest.tags ().begin (), latest.tags ().end (),
+                        latestTags.begin (), latestTags.end (),
                         std::inserter(diff, diff.begin ()));
 
     throw format ("The current interval does not have the '{1}' tag.", *diff.begin ());
   }
   else if (! tags.empty ())
   {
-    std::set_difference(latest.tags ().begin (), latest.tags ().end (),
+    std::set_difference(latestTags.begin (), latestTags.end (),
                         tags.begin (), tags.end (),
                         std::inserter(diff, diff.begin()));
   }
@@ -36,9 +36,7 @@
 #include <timew.h>
 #include <utf8.h>
 
-// Implemented in CmdChart.cpp.
-std::map <Datetime, std::string> createHolidayMap (Rules&, Range&);
-std::string renderHolidays (const std::map <Datetime, std::string>&);
+std::string renderHolidays (const Range&, const HolidayTable&);
 
 ////////////////////////////////////////////////////////////////////////////////
 int CmdSummary (
@@ -158,22 +156,29 @@ int CmdSummary (
 
   std::cout << '\n'
             << table.render ()
-            << (show_holidays ? renderHolidays (createHolidayMap (rules, range)) : "")
+            << (show_holidays ? renderHolidays (range, rules.holidays ()) : "")
             << '\n';
 
   return 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-std::string renderHolidays (const std::map <Datetime, std::string>& holidays)
+// A day with holidays in several locales shows the one of the last locale.
+std::string renderHolidays (const Range& range, const HolidayTable& holidays)
 {
   std::stringstream out;
 
-  for (auto& entry : holidays)
+  auto entries = holidays.within (range);
+  for (auto entry = entries.begin (); entry != entries.end (); ++entry)
   {
-    out << entry.first.toString ("Y-M-D")
-        << " "
-        << entry.second
+    if (entry + 1 != entries.end () && (entry + 1)->date == entry->date)
+      continue;
+
+    out << entry->date.toString ("Y-M-D")
+        << "  ["
+        << entry->locale
+        << "] "
+        << entry->name
         << '\n';
   }
 
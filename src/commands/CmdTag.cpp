@@ -99,15 +99,20 @@ int CmdTag (
   }
 
   // Apply tags to intervals.
+  std::vector <Interval> modified;
+  modified.reserve (intervals.size ());
+
   for (const auto& interval : intervals)
   {
-    Interval modified {interval};
-
-    modified.tag (tags);
+    modified.push_back (interval);
+    modified.back ().tag (tags);
+  }
 
-    database.modifyInterval (interval, modified, verbose);
+  database.modifyIntervals (intervals, modified, verbose);
 
-    if (verbose)
+  if (verbose)
+  {
+    for (const auto& interval : intervals)
     {
       std::cout << "Added " << joinQuotedIfNeeded (" ", tags) << " to @" << interval.id << '\n';
     }
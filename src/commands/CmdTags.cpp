@@ -52,13 +52,15 @@ int CmdTags (
   // Generate a unique, ordered list of tags.
   std::set <std::string> tags;
 
-  for (const auto& interval : getTracked (database, rules, filtering))
+  forEachTracked (database, rules, filtering, TrackedOrder::latest_first, [&tags] (const Interval& interval)
   {
-    for (const auto& tag : interval.tags ())
+    for (auto id : interval.tagIds ())
     {
-      tags.insert (tag);
+      tags.insert (TagDictionary::name (id));
     }
-  }
+
+    return true;
+  });
 
   // Shows all tags.
   if (tags.empty ())
@@ -24,7 +24,9 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <IntervalDelta.h>
 #include <IntervalFactory.h>
+#include <algorithm>
 #include <commands.h>
 #include <format.h>
 #include <iostream>
@@ -37,6 +39,40 @@ static void undoIntervalAction(UndoAction& action, Database& database)
   database.modifyInterval (after, before, false);
 }
 
+static void undoDeltaAction (UndoAction& action, Database& database)
+{
+  std::vector <Interval> from;
+  std::vector <Interval> to;
+
+  for (auto& entry : action.getEntries ())
+  {
+    auto delta = IntervalDelta::decode (entry);
+
+    if (delta.kind == IntervalDelta::Kind::added)
+    {
+      from.push_back (delta.interval);
+    }
+    else if (delta.kind == IntervalDelta::Kind::removed)
+    {
+      to.push_back (delta.interval);
+    }
+    else
+    {
+      auto candidates = database.intervalsStartingAt (delta.interval.start);
+      auto current = std::find_if (candidates.begin (), candidates.end (), [&delta] (const Interval& candidate) { return delta.matches (candidate); });
+      if (current == candidates.end ())
+      {
+        throw format ("Cannot undo, the interval starting at {1} has changed.", delta.interval.start.toISOLocalExtended ());
+      }
+
+      from.push_back (*current);
+      to.push_back (delta.revert (*current));
+    }
+  }
+
+  database.modifyIntervals (from, to, false);
+}
+
 static void undoConfigAction (UndoAction& action, Rules& rules, Journal& journal)
 {
   const std::string& before = action.getBefore ();
@@ -77,19 +113,24 @@ int CmdUndo (Rules& rules, Database& database, Journal& journal)
   }
   else
   {
-    for (auto& action : actions)
+    // Later actions may depend on earlier ones, so they are undone first.
+    for (auto action = actions.rbegin (); action != actions.rend (); ++action)
     {
       // Select database...
-      std::string type = action.getType ();
+      std::string type = action->getType ();
 
       // Rollback action...
-      if (type == "interval")
+      if (type == "delta")
+      {
+        undoDeltaAction (*action, database);
+      }
+      else if (type == "interval")
       {
-        undoIntervalAction (action, database);
+        undoIntervalAction (*action, database);
       }
       else if (type == "config")
       {
-        undoConfigAction (action, rules, journal);
+        undoConfigAction (*action, rules, journal);
       }
       else
       {
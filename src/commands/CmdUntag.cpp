@@ -99,15 +99,20 @@ int CmdUntag (
   }
 
   // Remove tags from intervals.
+  std::vector <Interval> modified;
+  modified.reserve (intervals.size ());
+
   for (const auto& interval : intervals)
   {
-    Interval modified {interval};
-
-    modified.untag (tags);
+    modified.push_back (interval);
+    modified.back ().untag (tags);
+  }
 
-    database.modifyInterval (interval, modified, verbose);
+  database.modifyIntervals (intervals, modified, verbose);
 
-    if (verbose)
+  if (verbose)
+  {
+    for (const auto& interval : intervals)
     {
       std::cout << "Removed " << joinQuotedIfNeeded (" ", tags) << " from @" << interval.id << '\n';
     }
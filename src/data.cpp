@@ -26,31 +26,30 @@
 
 #include <Datetime.h>
 #include <Duration.h>
+#include <ExclusionCache.h>
 #include <IntervalFactory.h>
 #include <IntervalFilter.h>
+#include <RangeSet.h>
 #include <algorithm>
 #include <format.h>
+#include <functional>
+#include <memory>
 #include <shared.h>
 #include <timew.h>
 
 ////////////////////////////////////////////////////////////////////////////////
-// Read rules and extract all holiday definitions. Create a Range for each
-// one that spans from midnight to midnight.
+// Create a Range for each holiday that spans from midnight to midnight.
 std::vector <Range> getHolidays (const Rules& rules)
 {
   std::vector <Range> results;
-  for (auto& holiday : rules.all ("holidays."))
+  for (auto& holiday : rules.holidays ())
   {
-    auto lastDot = holiday.rfind ('.');
-    if (lastDot != std::string::npos)
-    {
-      Range r;
-      Datetime d (holiday.substr (lastDot + 1), "Y_M_D");
-      r.start = d;
-      ++d;
-      r.end = d;
-      results.push_back (r);
-    }
+    Range r;
+    Datetime d (holiday.date);
+    r.start = d;
+    ++d;
+    r.end = d;
+    results.push_back (r);
   }
 
   debug (format ("Found {1} holidays", results.size ()));
@@ -58,14 +57,22 @@ std::vector <Range> getHolidays (const Rules& rules)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// [1] Read holiday definitions from the rules, extract their dates and create
-//     a set of Range from them.
-// [2] For 'exc day ...' exclusions, separate into daysOn and daysOff sets,
-//     based on whether the exclusion is additive.
-// [3] Treat daysOff as additional holidays.
-// [4] Subtract daysOn from the set of holidays.
-// [5] Take all the 'exc <dayOfWeek> ...' exclusions and expand them into
-//     concrete ranges within the overall range, adding them to the results.
+// The expansion of the rules in use, replaced when they change.
+static ExclusionCache& exclusionCache (const Rules& rules)
+{
+  static std::unique_ptr <ExclusionCache> cache;
+
+  if (! cache || cache->fingerprint () != rules.exclusionFingerprint ())
+    cache = std::make_unique <ExclusionCache> (rules);
+
+  return *cache;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// [1] Take the holidays from the exclusion cache, which reads them from the
+//     rules on a miss, and keep those that overlap the range.
+// [2] Add the 'exc days ...' exclusions, and the concrete ranges of the
+//     'exc <dayOfWeek> ...' exclusions, that overlap with the range.
 //
 // The result is the complete set of untrackable time that lies within the
 // input range. This will be a set of nights, weekends, holidays and lunchtimes.
@@ -73,61 +80,51 @@ std::vector <Range> getAllExclusions (
   const Rules& rules,
   const Range& range)
 {
+  auto& cache = exclusionCache (rules);
+
   // Start with the set of all holidays, intersected with range.
   std::vector <Range> results;
-  results = addRanges (range, results, getHolidays (rules));
-
-  // Load all exclusions from configuration.
-  std::vector <Exclusion> exclusions;
-  for (auto& name : rules.all ("exclusions."))
-    exclusions.emplace_back (lowerCase (name), rules.get (name));
-  debug (format ("Found {1} exclusions", exclusions.size ()));
-
-  // Find exclusions 'exc day on <date>' and remove from holidays.
-  // Find exclusions 'exc day off <date>' and add to holidays.
-  std::vector <Range> daysOn;
-  std::vector <Range> daysOff;
-  for (auto& exclusion : exclusions)
-  {
-    if (exclusion.tokens ()[1] == "day")
-    {
-      if (exclusion.additive ())
-        for (auto& r : exclusion.ranges (range))
-          daysOn.push_back (r);
-      else
-        for (auto& r : exclusion.ranges (range))
-          daysOff.push_back (r);
-    }
-  }
+  results = addRanges (range, results, cache.holidays ());
+
+  auto exclusionRanges = cache.exclusions (range);
+  cache.save ();
 
-  // daysOff are combined with existing holidays.
-  results = addRanges (range, results, daysOff);
-  if (! daysOn.empty ())
-    debug (format ("Found {1} additional working days", daysOn.size ()));
-  if (! daysOff.empty ())
-    debug (format ("Found {1} additional non-working days", daysOff.size ()));
+  return merge (addRanges (range, results, exclusionRanges));
+}
 
-  // daysOn are subtracted from the existing holidays.
-  results = subtractRanges (results, daysOn);
+////////////////////////////////////////////////////////////////////////////////
+// The exclusions from the start of an open interval up to now. Those that end
+// by a cut-off are remembered, so that a later run only expands the time since
+// then. The cut-off is the end of the last exclusion that ended by now, as no
+// exclusion found later can start before it without having been merged.
+static std::vector <Range> getLatestExclusions (
+  const Rules& rules,
+  const Datetime& start)
+{
+  auto& cache = exclusionCache (rules);
+  Datetime now;
 
-  // Expand all exclusions that are not 'exc day ...' into excluded ranges that
-  // overlap with range.
-  std::vector <Range> exclusionRanges;
-  for (auto& exclusion : exclusions)
+  Datetime cutoff {start};
+  std::vector <Range> exclusions;
+  if (! cache.recall (start, cutoff, exclusions) || now < cutoff)
   {
-    if (exclusion.tokens ()[1] != "day")
-    {
-      for (auto& r : exclusion.ranges (range))
-      {
-        if (! r.is_empty ())
-        {
-          exclusionRanges.push_back (r);
-        }
-      }
-    }
+    cutoff = start;
+    exclusions.clear ();
   }
 
-  return merge (addRanges (range, results, exclusionRanges));
+  for (auto& exclusion : getAllExclusions (rules, {cutoff, now}))
+    exclusions.push_back (exclusion);
+
+  exclusions = merge (exclusions);
+
+  auto complete = exclusions.begin ();
+  while (complete != exclusions.end () && complete->end <= now)
+    ++complete;
+
+  if (complete != exclusions.begin () && (complete - 1)->end != cutoff)
+    cache.remember (start, (complete - 1)->end, {exclusions.begin (), complete});
+
+  return exclusions;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -140,7 +137,7 @@ std::vector <Interval> expandLatest (const Interval& latest, const Rules& rules)
   // If the latest interval is open, check for synthetic intervals
   if (latest.is_open ())
   {
-    auto exclusions = getAllExclusions (rules, {latest.start, Datetime ()});
+    auto exclusions = getLatestExclusions (rules, latest.start);
     if (! exclusions.empty ())
     {
       std::vector <Interval> flattened = flatten (latest, exclusions);
@@ -250,41 +247,10 @@ std::vector <Interval> flatten (
 
 ////////////////////////////////////////////////////////////////////////////////
 // Simply merges a vector of ranges, without data loss.
-static bool rangeCompare (Range left, Range right)
-{
-  return left.start < right.start;
-}
-
 std::vector <Range> merge (
   const std::vector <Range>& ranges)
 {
-  // Shortcut.
-  if (ranges.size () < 2)
-    return ranges;
-
-  std::vector <Range> sorted {ranges};
-  std::sort (sorted.begin (), sorted.end (), rangeCompare);
-
-  unsigned int cursor = 0;
-  int merges = 0;
-  for (unsigned int i = 0; i < sorted.size (); ++i)
-  {
-    if (cursor && sorted[cursor - 1].overlaps (sorted[i]))
-    {
-      sorted[cursor - 1] = sorted[cursor - 1].combine (sorted[i]);
-      ++merges;
-    }
-    else
-    {
-      sorted[cursor] = sorted[i];
-      ++cursor;
-    }
-  }
-
-  if (merges)
-    sorted.resize (ranges.size () - merges);
-
-  return sorted;
+  return RangeSet (ranges).release ();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -304,7 +270,7 @@ std::vector <Range> addRanges (
     if (limits.overlaps (addition))
       results.push_back (addition);
 
-  return results;
+  return RangeSet (std::move (results)).release ();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -313,18 +279,7 @@ std::vector <Range> subtractRanges (
   const std::vector <Range>& ranges,
   const std::vector <Range>& subtractions)
 {
-  std::vector <Range> results = ranges;
-  for (auto& s : subtractions)
-  {
-    std::vector <Range> split_results;
-    for (auto& range : results)
-      for (auto& split_range : range.subtract (s))
-        split_results.push_back (split_range);
-
-    results = split_results;
-  }
-
-  return results;
+  return RangeSet (ranges).subtract (RangeSet (subtractions)).release ();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -375,14 +330,7 @@ bool matchesFilter (const Interval& interval, const Interval& filter)
 {
   if (matchesRange (interval, filter))
   {
-    for (auto& tag : filter.tags ())
-    {
-      if (! interval.hasTag (tag))
-      {
-        return false;
-      }
-    }
-    return true;
+    return interval.hasTags (filter.tagIds ());
   }
 
   return false;
@@ -409,15 +357,18 @@ Interval clip (const Interval& interval, const Range& range)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Return collection of intervals that match the filter (synthetic intervals
-// included) sorted by date
-std::vector <Interval> getTracked (
+// Walks the tracked intervals from the latest backwards, with the latest one
+// expanded into synthetic intervals, and passes those accepted by the filter
+// to the visitor, with their ids set, until the visitor returns false.
+// Returns the number of ids taken by the expanded latest interval.
+static int walkTracked (
   Database& database,
   const Rules& rules,
-  IntervalFilter& filter)
+  IntervalFilter& filter,
+  const std::function <bool (Interval&)>& visitor)
 {
   int current_id = 0;
-  std::vector <Interval> intervals;
+  int latest_ids = 0;
 
   auto it = database.begin ();
   auto end = database.end ();
@@ -429,19 +380,36 @@ std::vector <Interval> getTracked (
     Interval latest = IntervalFactory::fromSerialization (*it);
     ++it;
 
-    for (auto& interval : expandLatest (latest, rules))
+    auto expanded = expandLatest (latest, rules);
+    latest_ids = expanded.size ();
+    for (auto& interval : expanded)
     {
       ++current_id;
       if (filter.accepts (interval))
       {
         interval.id = current_id;
-        intervals.push_back (interval);
+        if (! visitor (interval))
+        {
+          return latest_ids;
+        }
       }
       else if (filter.is_done ())
       {
         break;
       }
     }
+
+    // Months after the filter range cannot hold any matches. If the latest
+    // interval lies in one of them, seek past them, but keep counting the
+    // skipped lines so that the ids stay the same.
+    unsigned int skipped = 0;
+    auto seek = database.begin (filter.range (), skipped);
+    if (skipped > 0)
+    {
+      it = seek;
+      current_id += skipped - 1;
+      debug (format ("Skipped {1} intervals after the filter range", skipped));
+    }
   }
 
   for (; it != end; ++it)
@@ -451,7 +419,10 @@ std::vector <Interval> getTracked (
 
     if (filter.accepts (interval))
     {
-      intervals.push_back (std::move (interval));
+      if (! visitor (interval))
+      {
+        break;
+      }
     }
     else if (filter.is_done ())
     {
@@ -462,6 +433,25 @@ std::vector <Interval> getTracked (
     }
   }
 
+  return latest_ids;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Return collection of intervals that match the filter (synthetic intervals
+// included) sorted by date
+std::vector <Interval> getTracked (
+  Database& database,
+  const Rules& rules,
+  IntervalFilter& filter)
+{
+  std::vector <Interval> intervals;
+
+  walkTracked (database, rules, filter, [&intervals] (Interval& interval)
+  {
+    intervals.push_back (std::move (interval));
+    return true;
+  });
+
   debug (format ("Loaded {1} tracked intervals", intervals.size ()));
 
   // By default, intervals are sorted by id, but getTracked needs to return the
@@ -471,6 +461,87 @@ std::vector <Interval> getTracked (
   return intervals;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Passes the intervals getTracked would return to the visitor, with the same
+// ids, but without holding them all in memory. The visitor returns false to
+// stop early.
+//
+// In latest first order, this is a single walk through the database. In
+// chronological order, the order of getTracked, the filters still expect to
+// see the intervals from the latest backwards. So a first pass walks the
+// database that way and only remembers which ids matched. A second pass then
+// walks it forwards and decodes just those.
+void forEachTracked (
+  Database& database,
+  const Rules& rules,
+  IntervalFilter& filter,
+  TrackedOrder order,
+  const std::function <bool (const Interval&)>& visitor)
+{
+  if (order == TrackedOrder::latest_first)
+  {
+    walkTracked (database, rules, filter, [&visitor] (Interval& interval)
+    {
+      return visitor (interval);
+    });
+
+    return;
+  }
+
+  std::vector <bool> matches;
+  std::vector <Interval> latest;
+  int oldest_id = 0;
+
+  auto latest_ids = walkTracked (database, rules, filter, [&] (Interval& interval)
+  {
+    if (interval.synthetic || interval.id == 1)
+    {
+      latest.push_back (interval);
+    }
+
+    if (matches.size () <= static_cast <size_t> (interval.id))
+    {
+      matches.resize (interval.id + 1);
+    }
+
+    matches[interval.id] = true;
+    oldest_id = std::max (oldest_id, interval.id);
+    return true;
+  });
+
+  debug (format ("Found {1} tracked intervals", std::count (matches.begin (), matches.end (), true)));
+
+  // All lines but the latest, oldest first, from the oldest match on. A line k
+  // lines before the latest has the id latest_ids + k, so the oldest line has
+  // the id latest_ids + count - 1, and the lines before the oldest match are
+  // skipped.
+  if (oldest_id > latest_ids)
+  {
+    int id = oldest_id;
+    for (auto it = database.rbegin (latest_ids + database.count () - 1 - oldest_id); id > latest_ids; ++it, --id)
+    {
+      if (matches[id])
+      {
+        Interval interval = IntervalFactory::fromSerialization (*it);
+        interval.id = id;
+        if (! visitor (interval))
+        {
+          return;
+        }
+      }
+    }
+  }
+
+  // The expanded latest interval was collected newest first.
+  for (auto it = latest.rbegin (); it != latest.rend (); ++it)
+  {
+    if (! visitor (*it))
+    {
+      return;
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Untracked time is that which is not excluded, and not filled. Gaps.
 std::vector <Range> getUntracked (
@@ -480,9 +551,13 @@ std::vector <Range> getUntracked (
 {
   bool found_match = false;
   std::vector <Range> inclusion_ranges;
-  for (auto& line : database)
+
+  // Ids are not needed here, so the skipped line count is ignored.
+  unsigned int skipped = 0;
+  auto end = database.end ();
+  for (auto it = database.begin (filter, skipped); it != end; ++it)
   {
-    Interval i = IntervalFactory::fromSerialization (line);
+    Interval i = IntervalFactory::fromSerialization (*it);
     if (matchesFilter (i, filter))
     {
       inclusion_ranges.push_back (i);
@@ -497,8 +572,10 @@ std::vector <Range> getUntracked (
     }
   }
 
-  auto available = subtractRanges ({filter}, getAllExclusions (rules, filter));
-  auto untracked = subtractRanges (available, inclusion_ranges);
+  auto untracked = RangeSet (filter)
+                     .subtract (RangeSet (getAllExclusions (rules, filter)))
+                     .subtract (RangeSet (std::move (inclusion_ranges)))
+                     .release ();
   debug (format ("Loaded {1} untracked ranges", untracked.size ()));
   return untracked;
 }
@@ -517,6 +594,21 @@ Interval getLatestInterval (Database& database)
   return i;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// The latest tracked interval, with id 1, as getTracked would list it last.
+// If the latest interval is expanded into synthetic intervals, that is the
+// newest of them. Only the end of the newest data file is read.
+Interval getLatestTracked (Database& database, const Rules& rules)
+{
+  auto latest = getLatestInterval (database);
+  if (latest.empty ())
+  {
+    return latest;
+  }
+
+  return expandLatest (latest, rules).front ();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Range getFullDay (const Datetime& day)
 {
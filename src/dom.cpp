@@ -28,7 +28,6 @@
 #include <IntervalFilterAllInRange.h>
 #include <IntervalFilterAllWithTags.h>
 #include <IntervalFilterAndGroup.h>
-#include <IntervalFilterFirstOf.h>
 #include <Pig.h>
 #include <format.h>
 #include <iostream>
@@ -49,23 +48,21 @@ bool domGet (
     // dom.active
     if (pig.skipLiteral ("active"))
     {
-      IntervalFilterFirstOf filtering {std::make_shared <IntervalFilterAllInRange> (Range {})};
-      auto intervals = getTracked (database, rules, filtering);
+      auto latest = getLatestTracked (database, rules);
+      bool found = ! latest.empty ();
 
       // dom.active
       if (pig.eos ())
       {
-        value = !intervals.empty () && intervals.at (0).is_open () ? "1" : "0";
+        value = found && latest.is_open () ? "1" : "0";
         return true;
       }
 
-      if (intervals.empty ())
+      if (! found)
       {
         return false;
       }
 
-      auto latest = intervals.at (0);
-
       // dom.active.start
       if (pig.skipLiteral (".start") &&
           latest.is_open ())
@@ -86,7 +83,7 @@ bool domGet (
       if (pig.skipLiteral (".tag.count") &&
           latest.is_open ())
       {
-        value = format ("{1}", latest.tags ().size ());
+        value = format ("{1}", latest.tagIds ().size ());
         return true;
       }
 
@@ -123,20 +120,19 @@ bool domGet (
         std::make_shared <IntervalFilterAllWithTags> (filter.tags ())
       });
 
-      auto tracked = getTracked (database, rules, filtering);
-      int count = static_cast <int> (tracked.size ());
-
       // dom.tracked.tags
       if (pig.skipLiteral ("tags"))
       {
         std::set <std::string> tags;
-        for (const auto& interval : tracked)
+        forEachTracked (database, rules, filtering, TrackedOrder::latest_first, [&tags] (const Interval& interval)
         {
-          for (const auto& tag : interval.tags ())
+          for (auto id : interval.tagIds ())
           {
-            tags.insert (tag);
+            tags.insert (TagDictionary::name (id));
           }
-        }
+
+          return true;
+        });
 
         std::stringstream s;
 
@@ -150,10 +146,11 @@ bool domGet (
       if (pig.skipLiteral ("ids"))
       {
         std::stringstream s;
-        for (auto& interval : tracked)
+        forEachTracked (database, rules, filtering, TrackedOrder::chronological, [&s] (const Interval& interval)
         {
           s << format ( "@{1} ", interval.id );
-        }
+          return true;
+        });
         value = s.str ();
         return true;
       }
@@ -161,51 +158,76 @@ bool domGet (
       // dom.tracked.count
       if (pig.skipLiteral ("count"))
       {
-        value = format ("{1}", tracked.size ());
+        int count = 0;
+        forEachTracked (database, rules, filtering, TrackedOrder::latest_first, [&count] (const Interval&)
+        {
+          ++count;
+          return true;
+        });
+
+        value = format ("{1}", count);
         return true;
       }
 
+      // The N-th latest tracked interval, found without reading further back.
       int n;
+      Interval interval;
+      bool found = false;
+      if (pig.getDigits (n) && n >= 1)
+      {
+        int remaining = n;
+        forEachTracked (database, rules, filtering, TrackedOrder::latest_first, [&] (const Interval& candidate)
+        {
+          if (--remaining > 0)
+          {
+            return true;
+          }
+
+          interval = candidate;
+          found = true;
+          return false;
+        });
+      }
+
       // dom.tracked.<N>.<...>
-      if (pig.getDigits (n) &&
-          n <= count        &&
+      if (found &&
           pig.skipLiteral ("."))
       {
         // dom.tracked.<N>.tag.count
         if (pig.skipLiteral ("tag.count"))
         {
-          value = format ("{1}", tracked[count - n].tags ().size ());
+          value = format ("{1}", interval.tagIds ().size ());
           return true;
         }
 
         // dom.tracked.<N>.start
         if (pig.skipLiteral ("start"))
         {
-          value = tracked[count - n].start.toISOLocalExtended ();
+          value = interval.start.toISOLocalExtended ();
           return true;
         }
 
         // dom.tracked.<N>.end
         if (pig.skipLiteral ("end"))
         {
-          if (tracked[count -n].is_open ())
+          if (interval.is_open ())
             value = "";
           else
-            value = tracked[count - n].end.toISOLocalExtended ();
+            value = interval.end.toISOLocalExtended ();
           return true;
         }
 
         // dom.tracked.<N>.duration
         if (pig.skipLiteral ("duration"))
         {
-          value = Duration (tracked[count - n].total ()).formatISO ();
+          value = Duration (interval.total ()).formatISO ();
           return true;
         }
 
         // dom.tracked.<N>.json
         if (pig.skipLiteral ("json"))
         {
-          value = tracked[count - n].json ();
+          value = interval.json ();
           return true;
         }
 
@@ -215,7 +237,7 @@ bool domGet (
             pig.getDigits (m))
         {
           std::vector <std::string> tags;
-          for (auto& tag : tracked[count - n].tags ())
+          for (auto& tag : interval.tags ())
             tags.push_back (tag);
 
           if (m <= static_cast <int> (tags.size ()))
@@ -436,7 +436,10 @@ std::map <std::string, Color> createTagColorMap (const Rules& rules, const std::
 
   for (const auto& interval : intervals)
   {
-    tags.insert (interval.tags ().begin (), interval.tags ().end ());
+    for (auto id : interval.tagIds ())
+    {
+      tags.insert (TagDictionary::name (id));
+    }
   }
 
   std::map <std::string, Color> mapping;
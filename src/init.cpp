@@ -24,6 +24,10 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <AtomicFile.h>
+#include <Datafile.h>
+#include <ExclusionCache.h>
+#include <IntervalFactory.h>
 #include <cmake.h>
 #include <commands.h>
 #include <format.h>
@@ -63,6 +67,7 @@ void initializeEntities (CLI& cli)
   cli.entity ("command", "help");
   cli.entity ("command", "--help");
   cli.entity ("command", "-h");
+  cli.entity ("command", "import");
   cli.entity ("command", "join");
   cli.entity ("command", "lengthen");
   cli.entity ("command", "modify");
@@ -173,7 +178,34 @@ void initializeDataJournalAndRules (
     }
   }
 
+  IntervalFactory::verifySerialization = rules.getBoolean ("debug.parser");
+
+  if (rules.has ("debug.serialization"))
+  {
+    auto level = rules.get ("debug.serialization");
+    if (level == "off")
+      Datafile::verification = Datafile::Verification::off;
+    else if (level == "sample")
+      Datafile::verification = Datafile::Verification::sample;
+    else if (level == "always")
+      Datafile::verification = Datafile::Verification::always;
+    else
+      throw format ("Invalid value for 'debug.serialization': '{1}'", level);
+  }
+
+  auto durability = rules.get ("durability");
+  if (durability == "none")
+    AtomicFile::durability = AtomicFile::Durability::none;
+  else if (durability == "batch")
+    AtomicFile::durability = AtomicFile::Durability::batch;
+  else if (durability == "full")
+    AtomicFile::durability = AtomicFile::Durability::full;
+  else
+    throw format ("Invalid value for 'durability': '{1}'", durability);
+
   std::string dbDataDir = paths::dbDataDir ();
+  ExclusionCache::file = dbDataDir + "/exclusions.cache";
+  ExclusionCache::state = dbDataDir + "/synthetic.state";
   journal.initialize (dbDataDir + "/undo.data", rules.getInteger ("journal.size"));
   // Initialize the database (no data read), but files are enumerated.
   database.initialize (dbDataDir, journal);
@@ -235,6 +267,7 @@ int dispatchCommand (
     else if (command == "help" ||
              command == "--help" ||
              command == "-h")          status = CmdHelp          (cli,                           extensions);
+    else if (command == "import")      status = CmdImport        (cli, rules, database, journal            );
     else if (command == "join")        status = CmdJoin          (cli, rules, database, journal            );
     else if (command == "lengthen")    status = CmdLengthen      (cli, rules, database, journal            );
     else if (command == "modify")      status = CmdModify        (cli, rules, database, journal            );
@@ -36,8 +36,11 @@
 #include <IntervalFilter.h>
 #include <Palette.h>
 #include <Rules.h>
+#include <functional>
 
 // data.cpp
+enum class TrackedOrder { chronological, latest_first };
+
 std::vector <Range>     getHolidays       (const Rules&);
 std::vector <Range>     getAllExclusions  (const Rules&, const Range&);
 std::vector <Range>     subset            (const Range&, const std::vector <Range>&);
@@ -52,8 +55,10 @@ bool                    matchesRange      (const Interval&, const Range&);
 bool                    matchesFilter     (const Interval&, const Interval&);
 Interval                clip              (const Interval&, const Range&);
 std::vector <Interval>  getTracked        (Database&, const Rules&, IntervalFilter&);
+void                    forEachTracked    (Database&, const Rules&, IntervalFilter&, TrackedOrder, const std::function <bool (const Interval&)>&);
 std::vector <Range>     getUntracked      (Database&, const Rules&, Interval&);
 Interval                getLatestInterval (Database&);
+Interval                getLatestTracked  (Database&, const Rules&);
 Range                   getFullDay        (const Datetime&);
 
 // validate.cpp
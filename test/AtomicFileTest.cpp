@@ -34,6 +34,7 @@
 #include <string>
 #include <test.h>
 #include <unistd.h>
+#include <vector>
 
 #ifdef FIU_ENABLE
 
@@ -415,6 +416,28 @@ int test (UnitTest& t)
     t.is (test.exists (), false, "AtomicFileTest: File is removed after finalize");
   }
 
+  {
+    tempDir.clear ();
+    Path test ("test");
+    std::vector <std::string> lines;
+    std::string written;
+    for (int i = 0; i < 10000; ++i)
+    {
+      lines.push_back (std::string (i % 50, 'x') + std::to_string (i));
+      written += lines.back () + '\n';
+    }
+
+    AtomicFile::write (test, lines);
+    AtomicFile::finalize_all ();
+    File::read (test, contents);
+    t.is (contents == written, true, "AtomicFileTest: write_lines writes all lines across buffers");
+
+    AtomicFile::append (test, "appended\n");
+    AtomicFile::finalize_all ();
+    File::read (test, contents);
+    t.is (contents == written + "appended\n", true, "AtomicFileTest: append copies the existing content");
+  }
+
   tempDir.clear();
   test_symlink(t);
 
@@ -423,7 +446,7 @@ int test (UnitTest& t)
 
 int main (int, char**)
 {
-  UnitTest t (22);
+  UnitTest t (24);
   try
   {
     int ret = test (t);
@@ -24,14 +24,17 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <AtomicFile.h>
 #include <Datafile.h>
 #include <Interval.h>
 #include <TempDir.h>
+#include <algorithm>
+#include <format.h>
 #include <test.h>
 
 int main ()
 {
-  UnitTest t (2);
+  UnitTest t (24);
   TempDir tempDir;
 
   try
@@ -57,6 +60,171 @@ int main ()
   {
     t.fail ("Uncaught exception");
   }
+
+  try
+  {
+    Datafile df;
+    df.initialize ("2020-07.data");
+    df.addInterval ({Datetime ("2020-07-01T01:00:00"), Datetime ("2020-07-01T02:00:00")});
+    df.addInterval ({Datetime ("2020-07-02T01:00:00"), Datetime ("2020-07-02T02:00:00")});
+    df.addInterval ({Datetime ("2020-07-03T01:00:00"), Datetime ("2020-07-03T02:00:00")});
+    df.commit ();
+    AtomicFile::finalize_all ();
+
+    t.ok (File ("2020-07.idx").exists (), "Datafile::commit writes the index");
+
+    Datafile reloaded;
+    reloaded.initialize ("2020-07.data");
+    t.is ((int) reloaded.count (), 3, "Datafile::count uses the index");
+    t.is ((int) reloaded.countFrom (Datetime ("2020-07-02T01:00:00")), 2, "Datafile::countFrom includes intervals starting at the given time");
+    t.is ((int) reloaded.countFrom (Datetime ("2020-07-04T00:00:00")), 0, "Datafile::countFrom is 0 after the last interval");
+
+    File::write ("2020-07.data", std::string ("inc 20200701T010000Z - 20200701T020000Z\n"));
+    Datafile modified;
+    modified.initialize ("2020-07.data");
+    t.is ((int) modified.countFrom (Datetime ("2020-07-01T00:00:00")), 0, "Datafile::countFrom ignores an outdated index");
+
+    auto& lines = modified.allLines ();
+    t.is ((int) lines.size (), 1, "Datafile::allLines splits the mapped file");
+    t.is (std::string (lines[0]), "inc 20200701T010000Z - 20200701T020000Z", "Datafile::allLines strips the newline");
+  }
+  catch (...)
+  {
+    t.fail ("Uncaught exception");
+  }
+
+  try
+  {
+    // More than one block of lines, and a trailing empty line.
+    std::string content;
+    for (int day = 1; day <= 28; ++day)
+    {
+      for (int hour = 0; hour < 10; ++hour)
+      {
+        content += format ("inc 202008{1}T{2}0000Z - 202008{1}T{2}3000Z # padding to make the line longer\n",
+                           (day < 10 ? "0" : "") + std::to_string (day),
+                           (hour < 10 ? "0" : "") + std::to_string (hour));
+      }
+    }
+    File::write ("2020-08.data", content + "inc 20200829T100000Z\n\n");
+
+    Datafile df;
+    df.initialize ("2020-08.data");
+    t.is (df.lastLine (), "inc 20200829T100000Z", "Datafile::lastLine reads the last non-empty line from the end");
+    df.allLines ();
+    t.is (df.lastLine (), "inc 20200829T100000Z", "Datafile::lastLine matches the loaded lines");
+
+    Datafile missing;
+    missing.initialize ("2020-09.data");
+    t.is (missing.lastLine (), "", "Datafile::lastLine of a missing file is empty");
+  }
+  catch (...)
+  {
+    t.fail ("Uncaught exception");
+  }
+
+  try
+  {
+    // Out of order, perhaps edited by hand.
+    File::write ("2020-11.data", std::string ("inc 20201102T010000Z - 20201102T020000Z\n"
+                                              "inc 20201101T010000Z - 20201101T020000Z\n"));
+
+    Datafile df;
+    df.initialize ("2020-11.data");
+    df.allLines ();
+    AtomicFile::finalize_all ();
+    t.notok (File ("2020-11.idx").exists (), "Datafile does not index an unsorted file");
+    t.is ((int) df.countFrom (Datetime ("2020-11-01T00:00:00")), 0, "Datafile::countFrom knows nothing of an unsorted file");
+
+    // Reading a file never writes its index.
+    File::write ("2020-12.data", std::string ("inc 20201201T010000Z - 20201201T020000Z\n"));
+
+    Datafile unindexed;
+    unindexed.initialize ("2020-12.data");
+    unindexed.allLines ();
+    AtomicFile::finalize_all ();
+    t.notok (File ("2020-12.idx").exists (), "Datafile does not index a file that is only read");
+  }
+  catch (...)
+  {
+    t.fail ("Uncaught exception");
+  }
+
+  try
+  {
+    Datafile df;
+    df.initialize ("2020-10.data");
+    df.addInterval ({Datetime ("2020-10-01T01:00:00"), Datetime ("2020-10-01T02:00:00")});
+    df.commit ();
+    AtomicFile::finalize_all ();
+
+    Datafile appended;
+    appended.initialize ("2020-10.data");
+    appended.addInterval ({Datetime ("2020-10-02T01:00:00"), Datetime ("2020-10-02T02:00:00")});
+    appended.commit ();
+    AtomicFile::finalize_all ();
+
+    std::string content;
+    File::read ("2020-10.data", content);
+    t.is (content, "inc 20201001T010000Z - 20201001T020000Z\ninc 20201002T010000Z - 20201002T020000Z\n", "Datafile::commit appends a later interval");
+    t.notok (File ("2020-10.data.append").exists (), "Datafile::commit removes the append marker");
+
+    Datafile reloaded;
+    reloaded.initialize ("2020-10.data");
+    t.is ((int) reloaded.countFrom (Datetime ("2020-10-02T00:00:00")), 1, "Datafile::commit appends to the index");
+
+    reloaded.addInterval ({Datetime ("2020-10-01T00:00:00"), Datetime ("2020-10-01T00:30:00")});
+    reloaded.commit ();
+    AtomicFile::finalize_all ();
+
+    File::read ("2020-10.data", content);
+    t.is (content, "inc 20201001T000000Z - 20201001T003000Z\ninc 20201001T010000Z - 20201001T020000Z\ninc 20201002T010000Z - 20201002T020000Z\n", "Datafile::commit rewrites the file for an earlier interval");
+
+    // An append that was interrupted is undone.
+    File::write ("2020-10.data.append", std::string ("40"));
+    AtomicFile::rollback (Path ("2020-10.data"));
+    File::read ("2020-10.data", content);
+    t.is (content, "inc 20201001T000000Z - 20201001T003000Z\n", "AtomicFile::rollback truncates to the recorded size");
+    t.notok (File ("2020-10.data.append").exists (), "AtomicFile::rollback removes the marker");
+  }
+  catch (...)
+  {
+    t.fail ("Uncaught exception");
+  }
+
+  try
+  {
+    Datafile df;
+    df.initialize ("2020-11.data");
+    df.addInterval ({Datetime ("2020-11-03T01:00:00"), Datetime ("2020-11-03T02:00:00")});
+    df.addInterval ({Datetime ("2020-11-01T01:00:00"), Datetime ("2020-11-01T02:00:00")});
+    df.addInterval ({Datetime ("2020-11-02T01:00:00"), Datetime ("2020-11-02T02:00:00")});
+
+    auto lines = df.allLines ();
+    t.ok (std::is_sorted (lines.begin (), lines.end ()), "Datafile::addInterval keeps lines sorted");
+
+    df.deleteInterval ({Datetime ("2020-11-02T01:00:00"), Datetime ("2020-11-02T02:00:00")});
+    df.commit ();
+    AtomicFile::finalize_all ();
+
+    std::string content;
+    File::read ("2020-11.data", content);
+    t.is (content, "inc 20201101T010000Z - 20201101T020000Z\ninc 20201103T010000Z - 20201103T020000Z\n", "Datafile::deleteInterval removes a line in the middle");
+
+    try
+    {
+      df.deleteInterval ({Datetime ("2020-11-02T01:00:00"), Datetime ("2020-11-02T02:00:00")});
+      t.fail ("Datafile::deleteInterval throws for a missing interval");
+    }
+    catch (const std::string&)
+    {
+      t.pass ("Datafile::deleteInterval throws for a missing interval");
+    }
+  }
+  catch (...)
+  {
+    t.fail ("Uncaught exception");
+  }
   return 0;
 }
 
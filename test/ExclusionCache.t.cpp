@@ -0,0 +1,114 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <AtomicFile.h>
+#include <Exclusion.h>
+#include <ExclusionCache.h>
+#include <TempDir.h>
+#include <algorithm>
+#include <test.h>
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (17);
+  TempDir tempDir;
+
+  try
+  {
+    ExclusionCache::file = "exclusions.cache";
+    ExclusionCache::state = "synthetic.state";
+
+    Rules rules;
+    rules.set ("exclusions.monday", "<8:00:00 12:00:00-12:45:00 >17:30:00");
+    rules.set ("exclusions.days.2026_09_01", "off");
+    rules.set ("holidays.eng-USA.2026_09_07", "Labor Day");
+
+    // Mondays 2026-08-31 and 2026-09-07 lie in different months.
+    Range range (Datetime ("2026-08-31"), Datetime ("2026-09-08"));
+    auto expected = Exclusion ("exclusions.monday", "<8:00:00 12:00:00-12:45:00 >17:30:00").ranges (range);
+    expected.insert (expected.begin (), Range (Datetime ("2026-09-01"), Datetime ("2026-09-02")));
+
+    ExclusionCache cache (rules);
+    t.is ((int) cache.holidays ().size (), 1, "ExclusionCache: one holiday");
+    t.ok (cache.exclusions (range) == expected, "ExclusionCache: day and weekday exclusions across a month boundary");
+    t.is ((int) cache.exclusions (Range (Datetime ("2026-09-03"), Datetime ("2026-09-05"))).size (), 0, "ExclusionCache: no exclusions outside the range");
+    t.is ((int) cache.exclusions (Range ()).size (), 0, "ExclusionCache: no exclusions in an empty range");
+
+    cache.save ();
+    AtomicFile::finalize_all ();
+    t.ok (File ("exclusions.cache").exists (), "ExclusionCache: save writes the cache file");
+
+    ExclusionCache reloaded (rules);
+    t.is (reloaded.fingerprint (), cache.fingerprint (), "ExclusionCache: same rules, same fingerprint");
+    t.ok (reloaded.holidays () == cache.holidays (), "ExclusionCache: holidays are reloaded");
+    t.ok (reloaded.exclusions (range) == expected, "ExclusionCache: exclusions are reloaded");
+
+    rules.set ("exclusions.monday", "<9:00:00");
+    ExclusionCache changed (rules);
+    t.ok (changed.fingerprint () != cache.fingerprint (), "ExclusionCache: changed rules, changed fingerprint");
+    t.is ((int) changed.exclusions (range).size (), 3, "ExclusionCache: changed rules are expanded again");
+
+    // The state of an open interval is recalled for the same start and rules.
+    Datetime start ("2026-08-31T09:00:00");
+    Datetime cutoff ("2026-08-31T12:45:00");
+    std::vector <Range> remembered {{Datetime ("2026-08-31T12:00:00"), cutoff}};
+    cache.remember (start, cutoff, remembered);
+    AtomicFile::finalize_all ();
+
+    Datetime recalledCutoff;
+    std::vector <Range> recalled;
+    t.ok (cache.recall (start, recalledCutoff, recalled), "ExclusionCache: recall for the same start");
+    t.ok (recalledCutoff == cutoff && recalled == remembered, "ExclusionCache: recall the cut-off and exclusions");
+    t.notok (cache.recall (Datetime ("2026-08-31T10:00:00"), recalledCutoff, recalled), "ExclusionCache: no recall for another start");
+    t.notok (changed.recall (start, recalledCutoff, recalled), "ExclusionCache: no recall for changed rules");
+
+    // Only the months nearest to the current one are kept in the file.
+    changed.exclusions (Range (Datetime ("2020-01-01"), Datetime ("2023-05-01")));
+    changed.save ();
+    AtomicFile::finalize_all ();
+
+    std::vector <std::string> lines;
+    File::read ("exclusions.cache", lines);
+    auto hasMonth = [&lines] (const std::string& name)
+    {
+      return std::any_of (lines.begin (), lines.end (), [&name] (const std::string& line) { return line.find ("month " + name) == 0; });
+    };
+
+    t.is ((int) lines.size (), 3 + 36, "ExclusionCache: save keeps at most 36 months");
+    t.notok (hasMonth ("2020-01"), "ExclusionCache: save drops the month farthest from now");
+    t.ok (hasMonth ("2023-04"), "ExclusionCache: save keeps the month nearest to now");
+  }
+
+  catch (const std::string& e)
+  {
+    t.diag (e);
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
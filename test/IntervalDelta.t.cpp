@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <IntervalDelta.h>
+#include <test.h>
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (15);
+
+  Interval before (Datetime ("20260105T090000Z"), Datetime ("20260105T100000Z"));
+  before.tag ("foo");
+  before.tag ("bar");
+  before.setAnnotation ("old");
+
+  // A change keeps the start, and only records what differs.
+  Interval after (before);
+  after.end = Datetime ("20260105T110000Z");
+  after.untag ("foo");
+  after.tag ("say \"hi\"");
+  after.setAnnotation ("back\\slash");
+
+  auto entries = IntervalDelta::encode ({before}, {after});
+  t.is (entries.size (), (size_t) 1, "IntervalDelta::encode pairs intervals by start");
+  t.is (entries[0], "~ 20260105T090000Z end 20260105T100000Z 20260105T110000Z +\"say \\\"hi\\\"\" -\"foo\" annotation \"old\" \"back\\\\slash\"",
+        "IntervalDelta::encode records only the changed fields");
+
+  auto delta = IntervalDelta::decode (entries[0]);
+  t.ok (delta.kind == IntervalDelta::Kind::changed, "IntervalDelta::decode '~' is a change");
+  t.ok (delta.matches (after), "IntervalDelta::matches the changed interval");
+  t.notok (delta.matches (before), "IntervalDelta::matches not the original interval");
+  t.ok (delta.revert (after) == before, "IntervalDelta::revert restores the original interval");
+
+  // Identical intervals are no change at all.
+  t.is (IntervalDelta::encode ({before}, {before}).size (), (size_t) 0, "IntervalDelta::encode skips unchanged intervals");
+
+  // Closing an open interval.
+  Interval open (Datetime ("20260105T120000Z"), Datetime (0));
+  Interval closed (Datetime ("20260105T120000Z"), Datetime ("20260105T130000Z"));
+  entries = IntervalDelta::encode ({open}, {closed});
+  t.is (entries[0], "~ 20260105T120000Z end - 20260105T130000Z", "IntervalDelta::encode writes an open end as '-'");
+  t.ok (IntervalDelta::decode (entries[0]).revert (closed) == open, "IntervalDelta::revert reopens the interval");
+
+  // Intervals without a partner are kept whole.
+  entries = IntervalDelta::encode ({before}, {open});
+  t.is (entries.size (), (size_t) 2, "IntervalDelta::encode keeps unpaired intervals");
+  t.is (entries[0], "- " + before.serialize (), "IntervalDelta::encode writes removals first");
+  t.is (entries[1], "+ " + open.serialize (), "IntervalDelta::encode writes additions");
+
+  delta = IntervalDelta::decode (entries[0]);
+  t.ok (delta.kind == IntervalDelta::Kind::removed && delta.interval == before, "IntervalDelta::decode '-' holds the whole interval");
+
+  try
+  {
+    IntervalDelta::decode ("~ 20260105T120000Z length 5");
+    t.fail ("IntervalDelta::decode rejects unknown fields");
+  }
+  catch (const std::string&)
+  {
+    t.pass ("IntervalDelta::decode rejects unknown fields");
+  }
+
+  try
+  {
+    IntervalDelta::decode ("~ 20260105T120000Z +\"unterminated");
+    t.fail ("IntervalDelta::decode rejects unterminated strings");
+  }
+  catch (const std::string&)
+  {
+    t.pass ("IntervalDelta::decode rejects unterminated strings");
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Interval.h>
+#include <IntervalFactory.h>
+#include <test.h>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// Both decoders must agree on every line the fast one accepts.
+static void testAgreement (UnitTest& t, const std::string& line)
+{
+  Interval scanned;
+  if (IntervalFactory::scanSerialization (line, scanned))
+  {
+    t.ok (scanned == IntervalFactory::lexSerialization (line), "scan == lex: " + line);
+  }
+  else
+  {
+    t.skip ("not scanned: " + line);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (43);
+
+  // Everything Interval::serialize writes for ordinary tags and annotations is
+  // decoded by the fast path, and round-trips.
+  std::vector <Interval> intervals;
+  intervals.emplace_back ();
+  intervals.emplace_back (Datetime ("20200131T235959Z"), Datetime ());
+  intervals.emplace_back (Datetime ("19700101T000001Z"), Datetime ("21001231T235959Z"));
+  intervals.emplace_back (Datetime ("20240229T120000Z"), Datetime ("20240301T000000Z"));
+
+  Interval tagged {Datetime ("20200601T080000Z"), Datetime ("20200601T093000Z")};
+  tagged.tag ("foo");
+  tagged.tag ("bar2");
+  tagged.tag ("Trans-Europe Express");
+  tagged.tag ("tag with \"quotes\"");
+  tagged.tag ("a_b");
+  intervals.push_back (tagged);
+
+  Interval annotated {tagged};
+  annotated.setAnnotation ("an \"annotated\" line - with # signs");
+  intervals.push_back (annotated);
+
+  Interval unicode;
+  unicode.start = Datetime ("20200601T080000Z");
+  unicode.setAnnotation ("Grüße, 日本語 🙂");
+  intervals.push_back (unicode);
+
+  for (auto& interval : intervals)
+  {
+    auto line = interval.serialize ();
+
+    Interval scanned;
+    t.ok (IntervalFactory::scanSerialization (line, scanned), "scanned: " + line);
+    t.ok (scanned == interval, "scan round-trips: " + line);
+    t.ok (scanned == IntervalFactory::lexSerialization (line), "scan == lex: " + line);
+  }
+
+  // Hand-written lines, including ones left to the Lexer.
+  for (auto& line : std::vector <std::string> {
+         "inc",
+         "inc  19700101T000001Z  -  19700101T000002Z  #  foo   bar",
+         "inc 20200101T000000Z - 20200101T010000Z # # \"\"",
+         "inc 20200101T000000Z - 20200101T010000Z # foo #",
+         "inc 20200101T000000Z - 20200101T010000Z # foo # plain words",
+         "inc \"20200101T000000Z\" # foo",
+         "inc 20200101T000000Z - # foo",
+         "inc 20200101T000000Z - 20200101T010000Z foo",
+         "inc 20200101T000000Z # 123 abc123",
+         "inc 20200101T000000Z # Ünïcödé",
+         "inc 20200101T000000Z # foo-bar",
+         "inc 20200101T000000Z # \"tab\\there\"",
+         "inc 20200101T000000Z # 'single quoted'",
+         "inc 20200101T000000Z # \"U+00e9\"",
+         "inc 20200101T000000Z # \"unterminated",
+         "inc 20200101T000000Z # \"adjacent\"word",
+         "inc 20201301T000000Z # foo",
+         "inc 20200230T000000Z # foo",
+       })
+  {
+    testAgreement (t, line);
+  }
+
+  // The fast path only accepts well-formed timestamps, so the Lexer decides
+  // about the others.
+  Interval scanned;
+  t.notok (IntervalFactory::scanSerialization ("inc 20201301T000000Z", scanned), "month 13 is not scanned");
+  t.notok (IntervalFactory::scanSerialization ("inc 20200101T250000Z", scanned), "hour 25 is not scanned");
+  t.notok (IntervalFactory::scanSerialization ("exc 20200101T000000Z", scanned), "exclusions are not scanned");
+  t.notok (IntervalFactory::scanSerialization ("", scanned), "empty lines are not scanned");
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Datetime.h>
+#include <IsoTimestamp.h>
+#include <test.h>
+
+static_assert (IsoTimestamp::daysFromCivil (1970, 1, 1) == 0);
+static_assert (IsoTimestamp::daysFromCivil (2000, 3, 1) == 11017);
+static_assert ([] { time_t epoch = 0; return IsoTimestamp::decode ("20200229T235959Z", epoch) && epoch == 1583020799; } ());
+static_assert ([] { char out[IsoTimestamp::length] {}; IsoTimestamp::encode (1583020799, out); return std::string_view (out, IsoTimestamp::length) == "20200229T235959Z"; } ());
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (14);
+
+  // Every day from 1970 to 2100, at a different time of day each, must match
+  // Datetime, and decode back to the same epoch.
+  int mismatches = 0;
+  int failures = 0;
+  time_t last = Datetime ("21001231T235959Z").toEpoch ();
+  for (time_t epoch = 0; epoch <= last; epoch += 86400 + 3607)
+  {
+    auto encoded = IsoTimestamp::encode (epoch);
+    if (encoded != Datetime (epoch).toISO ())
+      ++mismatches;
+
+    time_t decoded = 0;
+    if (! IsoTimestamp::decode (encoded, decoded) || decoded != epoch)
+      ++failures;
+  }
+
+  t.is (mismatches, 0, "IsoTimestamp::encode matches Datetime::toISO from 1970 to 2100");
+  t.is (failures,   0, "IsoTimestamp::decode round-trips from 1970 to 2100");
+
+  time_t epoch = 0;
+  t.is (IsoTimestamp::encode (0), "19700101T000000Z", "IsoTimestamp::encode (0)");
+  t.is (IsoTimestamp::encode (last), "21001231T235959Z", "IsoTimestamp::encode (2100-12-31)");
+  t.ok (IsoTimestamp::decode ("20000229T120000Z", epoch), "IsoTimestamp::decode accepts 2000-02-29");
+  t.ok (epoch == Datetime ("20000229T120000Z").toEpoch (), "IsoTimestamp::decode 2000-02-29 matches Datetime");
+
+  // Anything but the exact form is rejected.
+  t.notok (IsoTimestamp::decode ("21000229T000000Z", epoch), "IsoTimestamp::decode rejects 2100-02-29");
+  t.notok (IsoTimestamp::decode ("20201301T000000Z", epoch), "IsoTimestamp::decode rejects month 13");
+  t.notok (IsoTimestamp::decode ("20200100T000000Z", epoch), "IsoTimestamp::decode rejects day 0");
+  t.notok (IsoTimestamp::decode ("20200101T240000Z", epoch), "IsoTimestamp::decode rejects hour 24");
+  t.notok (IsoTimestamp::decode ("20200101T006000Z", epoch), "IsoTimestamp::decode rejects minute 60");
+  t.notok (IsoTimestamp::decode ("20200101T000000",  epoch), "IsoTimestamp::decode rejects a missing Z");
+  t.notok (IsoTimestamp::decode ("2020-01-01T00:00", epoch), "IsoTimestamp::decode rejects the extended form");
+  t.notok (IsoTimestamp::decode ("20200101X000000Z", epoch), "IsoTimestamp::decode rejects a missing T");
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
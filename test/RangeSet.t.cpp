@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <RangeSet.h>
+#include <test.h>
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string dump (const RangeSet& set)
+{
+  std::string out;
+  for (auto& range : set)
+  {
+    out += (out.empty () ? "" : ",") +
+           range.start.toISO () + "-" + (range.is_ended () ? range.end.toISO () : "");
+  }
+
+  return out;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (13);
+
+  Datetime h8  ("20260105T080000Z");
+  Datetime h9  ("20260105T090000Z");
+  Datetime h10 ("20260105T100000Z");
+  Datetime h11 ("20260105T110000Z");
+  Datetime h12 ("20260105T120000Z");
+
+  // Unsorted, overlapping and empty ranges are normalized.
+  RangeSet set ({{h11, h12}, {h8, h9}, {h8, h10}, {h10, h10}, {h8, h9}});
+  t.is (dump (set), "20260105T080000Z-20260105T100000Z,20260105T110000Z-20260105T120000Z", "RangeSet normalizes its ranges");
+  t.is (set.size (), (size_t) 2, "RangeSet holds two ranges");
+  t.is (dump (RangeSet ({{h9, h10}, {h8, h9}})), "20260105T080000Z-20260105T090000Z,20260105T090000Z-20260105T100000Z", "RangeSet keeps touching ranges apart");
+  t.ok (RangeSet (Range (h9, h9)).empty (), "RangeSet drops an empty range");
+
+  RangeSet open ({{h10, Datetime (0)}, {h11, h12}});
+  t.is (dump (open), "20260105T100000Z-", "RangeSet merges ranges into an open range");
+
+  RangeSet other (Range (h9, h11));
+  t.is (dump (set.unite (other)), "20260105T080000Z-20260105T110000Z,20260105T110000Z-20260105T120000Z", "RangeSet::unite");
+  t.is (dump (set.intersect (other)), "20260105T090000Z-20260105T100000Z", "RangeSet::intersect");
+  t.is (dump (set.subtract (other)), "20260105T080000Z-20260105T090000Z,20260105T110000Z-20260105T120000Z", "RangeSet::subtract");
+  t.is (dump (open.subtract (other)), "20260105T110000Z-", "RangeSet::subtract from an open range");
+  t.is (dump (other.subtract (open)), "20260105T090000Z-20260105T100000Z", "RangeSet::subtract an open range");
+  t.is (dump (other.intersect (open)), "20260105T100000Z-20260105T110000Z", "RangeSet::intersect with an open range");
+
+  // lower_bound finds the first range ending after a time.
+  t.ok (set.lower_bound (h10) == set.begin () + 1, "RangeSet::lower_bound skips a range ending at the time");
+  t.ok (set.lower_bound (h12) == set.end (), "RangeSet::lower_bound past the last range");
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
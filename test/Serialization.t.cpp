@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Interval.h>
+#include <IntervalFactory.h>
+#include <random>
+#include <test.h>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// Words and separators from which tags and annotations are generated. They
+// cover plain ASCII, multi-byte UTF-8 and everything that makes
+// Interval::serialize quote or escape its output.
+static const std::vector <std::string> words {
+  "foo", "Bar", "x", "a1", "é", "Grüße", "日本語", "🙂", "Ωmega"
+};
+
+static const std::vector <std::string> tagSeparators {
+  "", " ", "-", "_", "+", "/", "\"", "=", "%", "(", ")"
+};
+
+static const std::vector <std::string> annotationSeparators {
+  "", " ", " - ", "#", " # ", "\"", "'", ",", ":", "_"
+};
+
+////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+static const T& pick (std::mt19937& random, const std::vector <T>& choices)
+{
+  return choices[std::uniform_int_distribution <size_t> (0, choices.size () - 1) (random)];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A word, followed by up to three separator-word pairs.
+static std::string phrase (std::mt19937& random, const std::vector <std::string>& separators)
+{
+  std::string text = pick (random, words);
+  for (auto n = std::uniform_int_distribution <int> (0, 3) (random); n > 0; --n)
+  {
+    text += pick (random, separators) + pick (random, words);
+  }
+
+  return text;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static Interval generate (std::mt19937& random)
+{
+  // From 1970 to the end of 2099.
+  std::uniform_int_distribution <time_t> epochs (1, 4102444799);
+  time_t start = epochs (random);
+  time_t end = epochs (random);
+  if (end < start)
+  {
+    std::swap (start, end);
+  }
+
+  // Every fourth interval is open.
+  if (std::uniform_int_distribution <int> (0, 3) (random) == 0)
+  {
+    end = 0;
+  }
+
+  Interval interval {Datetime (start), Datetime (end)};
+
+  for (auto n = std::uniform_int_distribution <int> (0, 4) (random); n > 0; --n)
+  {
+    interval.tag (phrase (random, tagSeparators));
+  }
+
+  if (std::uniform_int_distribution <int> (0, 1) (random))
+  {
+    interval.setAnnotation (phrase (random, annotationSeparators));
+  }
+
+  return interval;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Checks a property on every generated interval, reporting only the first one
+// it fails for.
+static void property (
+  UnitTest& t,
+  const std::vector <Interval>& intervals,
+  bool (*holds) (const Interval&, const std::string&),
+  const std::string& name)
+{
+  for (auto& interval : intervals)
+  {
+    auto line = interval.serialize ();
+
+    std::string error;
+    try
+    {
+      if (holds (interval, line))
+      {
+        continue;
+      }
+    }
+    catch (const std::string& what)
+    {
+      error = what;
+    }
+
+    t.fail (name);
+    t.diag ("  " + line);
+    if (! error.empty ())
+    {
+      t.diag ("  " + error);
+    }
+
+    return;
+  }
+
+  t.pass (name);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (6);
+
+  // A fixed seed keeps failures reproducible.
+  std::mt19937 random (20261017);
+  std::vector <Interval> intervals;
+  for (int i = 0; i < 2000; ++i)
+  {
+    intervals.push_back (generate (random));
+  }
+
+  property (t, intervals, [] (const Interval&, const std::string& line)
+  {
+    return line.find ('\n') == std::string::npos;
+  }, "serialize writes a single line");
+
+  property (t, intervals, [] (const Interval& interval, const std::string& line)
+  {
+    return IntervalFactory::fromSerialization (line) == interval;
+  }, "fromSerialization round-trips");
+
+  property (t, intervals, [] (const Interval& interval, const std::string& line)
+  {
+    return IntervalFactory::lexSerialization (line) == interval;
+  }, "lexSerialization round-trips");
+
+  property (t, intervals, [] (const Interval& interval, const std::string& line)
+  {
+    Interval scanned;
+    return ! IntervalFactory::scanSerialization (line, scanned) || scanned == interval;
+  }, "scanSerialization round-trips when it applies");
+
+  property (t, intervals, [] (const Interval&, const std::string& line)
+  {
+    return IntervalFactory::fromSerialization (line).serialize () == line;
+  }, "serialize is stable after a round-trip");
+
+  property (t, intervals, [] (const Interval& interval, const std::string&)
+  {
+    return IntervalFactory::fromJson (interval.json ()) == interval;
+  }, "fromJson round-trips");
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
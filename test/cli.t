@@ -56,7 +56,8 @@ class TestCLI(TestCase):
         assert os.path.exists(self.t.env["TIMEWARRIORDB"])
         assert os.path.exists(os.path.join(self.t.env["TIMEWARRIORDB"], "data"))
         assert os.path.exists(os.path.join(self.t.env["TIMEWARRIORDB"], "data", "tags.data"))
-        assert not os.path.exists(os.path.join(self.t.env["TIMEWARRIORDB"], "data", "undo.data"))
+        assert not os.path.exists(os.path.join(self.t.env["TIMEWARRIORDB"], "data", "undo.segments"))
+        assert not os.path.exists(os.path.join(self.t.env["TIMEWARRIORDB"], "data", "undo.0.data"))
 
     def test_tag_database_is_recreated(self):
         """Verify that calling 'timew' recreates tag database"""
@@ -102,6 +103,23 @@ class TestCLI(TestCase):
         code, out, err = self.t.runError("bogus")
         self.assertIn("'bogus' is not a timew command. See 'timew help'.", err)
 
+    def test_TimeWarrior_with_durability(self):
+        """Changes are stored with every durability setting"""
+        for hour, durability in enumerate(["none", "batch", "full"]):
+            track = "track 2022-12-10T{0:02d}:00:00Z - 2022-12-10T{0:02d}:30:00Z {1} rc.durability={1}".format(hour, durability)
+            self.t(track)
+            self.t("undo rc.durability={}".format(durability))
+            self.t(track)
+
+        j = self.t.export()
+        self.assertEqual(len(j), 3)
+        self.assertClosedInterval(j[2], expectedTags=["full"])
+
+    def test_TimeWarrior_with_invalid_durability(self):
+        """An unknown durability setting should be an error"""
+        code, out, err = self.t.runError("rc.durability=sometimes")
+        self.assertIn("Invalid value for 'durability': 'sometimes'", err)
+
 
 if __name__ == "__main__":
     from simpletap import TAPTestRunner
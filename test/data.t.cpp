@@ -72,8 +72,8 @@ void test_merge (
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t ((7 + 7 + 7 + 4 + 4 + 10) +
-              (1 + 3 + 5 + 5 + 3 + 3 + 7)  +
+  UnitTest t ((7 + 7 + 7 + 4 + 4 + 10 + 7) +
+              (1 + 3 + 5 + 5 + 3 + 3 + 7 + 5)  +
               30);
 
   // std::vector <Interval> flatten (const Interval&, std::vector <Range>&);
@@ -151,6 +151,19 @@ int main (int, char**)
                  "inc 20160523T170000Z - 20160523T213000Z # foo",
                  "inc 20160524T040000Z # foo"});
 
+  // Starts inside an evening exclusion, which touches the night exclusion
+  // after midnight. Merging keeps them apart, so the night is still enclosed.
+  // input        [-------------------)
+  // exc      [-------)[-----)
+  // output       [---)      [--------)
+  test_flatten (t,
+                "[7] (inc) - (1 overlapping exc, 1 touching enclosed exc) = (2 inc)",
+                "inc 20160523T200000Z - 20160524T120000Z # foo",
+                merge ({{Datetime ("20160523T180000Z"), Datetime ("20160524T000000Z")},
+                        {Datetime ("20160524T000000Z"), Datetime ("20160524T090000Z")}}),
+                {"inc 20160523T200000Z - 20160524T000000Z # foo",
+                 "inc 20160524T090000Z - 20160524T120000Z # foo"});
+
   // Simple range merging.
   test_merge (t,
               "Empty range",
@@ -176,6 +189,13 @@ int main (int, char**)
               {{Datetime ("20160704T000000Z"), Datetime ("20160704T010000Z")},
                {Datetime ("20160704T020000Z"), Datetime ("20160704T030000Z")}});
 
+  test_merge (t,
+              "Adjacent ranges",
+              {{Datetime ("20160704T010000Z"), Datetime ("20160704T020000Z")},
+               {Datetime ("20160704T000000Z"), Datetime ("20160704T010000Z")}},
+              {{Datetime ("20160704T000000Z"), Datetime ("20160704T010000Z")},
+               {Datetime ("20160704T010000Z"), Datetime ("20160704T020000Z")}});
+
   test_merge (t,
               "Overlapping unsorted ranges",
               {{Datetime ("20160704T010000Z"), Datetime ("20160704T030000Z")},
@@ -331,6 +331,14 @@ class TestDOMTracked(TestCase):
         code, out, err = self.t.runError("get dom.tracked.3.start")
         self.assertIn("DOM reference 'dom.tracked.3.start' is not valid.", err)
 
+    def test_dom_tracked_zero_start_invalid(self):
+        """Test 'dom.tracked.0.start' is not valid"""
+        self.t("track :yesterday one two")
+        self.t("start")
+
+        code, out, err = self.t.runError("get dom.tracked.0.start")
+        self.assertIn("DOM reference 'dom.tracked.0.start' is not valid.", err)
+
     def test_dom_tracked_N_start_active(self):
         """Test 'dom.tracked.N.start' with active track"""
         self.t("track :yesterday one two")
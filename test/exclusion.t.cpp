@@ -32,7 +32,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (261);
+  UnitTest t (265);
 
   try
   {
@@ -391,6 +391,21 @@ int main (int, char**)
     t.is (ranges[0].end.toISOLocalExtended (),   "2016-05-13T08:00:00", "Exclusion range[0].end()   --> 2016-05-13T08:00:00");
     t.is (ranges[1].start.toISOLocalExtended (), "2016-05-13T12:00:00", "Exclusion range[1].start() --> 2016-05-13T12:00:00");
     t.is (ranges[1].end.toISOLocalExtended (),   "2016-05-13T12:45:00", "Exclusion range[1].end()   --> 2016-05-13T12:45:00");
+
+    // Blocks are yielded in order of their start, whatever their order in the
+    // configuration, and the cursor yields the same ranges one at a time.
+    Exclusion e12 ("exclusions.monday", ">17:30:00 12:00:00-12:45:00 <8:00:00");
+    ranges = e12.ranges (r);
+    t.ok (ranges.size () == 12,                                         "Exclusion ranges --> [12]");
+    t.is (ranges[2].start.toISOLocalExtended (), "2015-12-21T17:30:00", "Exclusion range[2].start() --> 2015-12-21T17:30:00");
+
+    auto cursor = e12.cursor (r);
+    std::vector <Range> yielded;
+    Range next;
+    while (cursor.next (next))
+      yielded.push_back (next);
+    t.is ((int) yielded.size (), (int) ranges.size (),                  "Exclusion cursor --> as many ranges as ranges ()");
+    t.ok (yielded == ranges,                                            "Exclusion cursor --> same as ranges");
   }
 
   catch (const std::string& e)
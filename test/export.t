@@ -223,6 +223,48 @@ class TestExport(TestCase):
                                   expectedId=2,
                                   expectedTags=["Tag1"])
 
+    def test_export_range_in_earlier_month_keeps_ids(self):
+        """Export with a range in an earlier month keeps ids of later months"""
+        self.t("track Tag1 2021-01-10T00:00:00 - 2021-01-10T01:00:00")
+        self.t("track Tag2 2021-01-31T23:00:00 - 2021-02-01T01:00:00")
+        self.t("track Tag3 2021-02-10T00:00:00 - 2021-02-10T01:00:00")
+        self.t("track Tag4 2021-03-10T00:00:00 - 2021-03-10T01:00:00")
+        self.t("track Tag5 2021-03-11T00:00:00 - 2021-03-11T01:00:00")
+
+        j = self.t.export("2021-02-01 - 2021-02-02")
+
+        self.assertEqual(len(j), 1)
+        self.assertClosedInterval(j[0],
+                                  expectedId=4,
+                                  expectedTags=["Tag2"])
+
+    def test_export_across_months_is_sorted_by_date(self):
+        """Export across several months lists intervals oldest first, with ids counting from the latest"""
+        self.t("track Tag1 2021-01-10T00:00:00 - 2021-01-10T01:00:00")
+        self.t("track Tag2 2021-02-10T00:00:00 - 2021-02-10T01:00:00")
+        self.t("track Tag3 2021-02-11T00:00:00 - 2021-02-11T01:00:00")
+        self.t("track Tag4 2021-03-10T00:00:00 - 2021-03-10T01:00:00")
+
+        j = self.t.export()
+
+        self.assertEqual(len(j), 4)
+        for index, tag in enumerate(["Tag1", "Tag2", "Tag3", "Tag4"]):
+            self.assertClosedInterval(j[index],
+                                      expectedId=4 - index,
+                                      expectedTags=[tag])
+
+    def test_export_ids_across_months(self):
+        """Export by ids across several months keeps ids and order"""
+        self.t("track Tag1 2021-01-10T00:00:00 - 2021-01-10T01:00:00")
+        self.t("track Tag2 2021-02-10T00:00:00 - 2021-02-10T01:00:00")
+        self.t("track Tag3 2021-03-10T00:00:00 - 2021-03-10T01:00:00")
+
+        j = self.t.export("@1 @3")
+
+        self.assertEqual(len(j), 2)
+        self.assertClosedInterval(j[0], expectedId=3, expectedTags=["Tag1"])
+        self.assertClosedInterval(j[1], expectedId=1, expectedTags=["Tag3"])
+
 
 if __name__ == "__main__":
     from simpletap import TAPTestRunner
@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+
+###############################################################################
+#
+# Copyright 2026, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# https://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import os
+import sys
+import unittest
+
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Timew, TestCase
+
+
+class TestImport(TestCase):
+    def setUp(self):
+        """Executed before each test in the class"""
+        self.t = Timew()
+
+    def test_import_nothing(self):
+        """Import of empty input does nothing"""
+        code, out, err = self.t("import", input="")
+        self.assertIn("Nothing to import.", out)
+        self.assertEqual(len(self.t.export()), 0)
+
+    def test_import_export(self):
+        """Import of 'timew export' output restores the intervals"""
+        source = Timew()
+        source("track 2022-12-10T00:00:00Z - 2022-12-10T01:00:00Z foo")
+        source("track 2023-01-10T01:00:00Z - 2023-01-10T02:00:00Z bar 'with space'")
+        source("annotate @1 'some \"quoted\" note'")
+        source("start 2023-02-01T08:00:00Z baz")
+        code, exported, err = source("export")
+
+        code, out, err = self.t("import", input=exported)
+        self.assertIn("Imported 3 intervals.", out)
+
+        j = self.t.export()
+        self.assertEqual(len(j), 3)
+        self.assertClosedInterval(j[0],
+                                  expectedStart="20221210T000000Z",
+                                  expectedEnd="20221210T010000Z",
+                                  expectedTags=["foo"])
+        self.assertClosedInterval(j[1],
+                                  expectedStart="20230110T010000Z",
+                                  expectedEnd="20230110T020000Z",
+                                  expectedTags=["bar", "with space"],
+                                  expectedAnnotation="some \"quoted\" note")
+        self.assertOpenInterval(j[2],
+                                expectedStart="20230201T080000Z",
+                                expectedTags=["baz"])
+
+    def test_import_inc_lines(self):
+        """Import of data file lines"""
+        self.t("import", input="inc 20221210T010000Z - 20221210T020000Z # bar\n"
+                               "\n"
+                               "inc 20221210T000000Z - 20221210T010000Z # foo\n")
+
+        j = self.t.export()
+        self.assertEqual(len(j), 2)
+        self.assertClosedInterval(j[0], expectedStart="20221210T000000Z", expectedTags=["foo"])
+        self.assertClosedInterval(j[1], expectedStart="20221210T010000Z", expectedTags=["bar"])
+
+    def test_import_overlapping_records(self):
+        """Import of overlapping records is rejected"""
+        code, out, err = self.t.runError("import", input="inc 20221210T000000Z - 20221210T020000Z # foo\n"
+                                                         "inc 20221210T010000Z - 20221210T030000Z # bar\n")
+        self.assertIn("overlaps with", err)
+        self.assertEqual(len(self.t.export()), 0)
+
+    def test_import_overlapping_stored_interval(self):
+        """Import of a record overlapping a stored interval is rejected"""
+        self.t("track 2022-12-10T00:00:00Z - 2022-12-10T02:00:00Z foo")
+
+        code, out, err = self.t.runError("import", input="inc 20221210T010000Z - 20221210T030000Z # bar\n")
+        self.assertIn("overlaps with", err)
+        self.assertEqual(len(self.t.export()), 1)
+
+    def test_import_adjacent_to_stored_interval(self):
+        """Import of a record adjacent to a stored interval is accepted"""
+        self.t("track 2022-12-10T00:00:00Z - 2022-12-10T02:00:00Z foo")
+        self.t("import", input="inc 20221210T020000Z - 20221210T030000Z # bar\n")
+
+        self.assertEqual(len(self.t.export()), 2)
+
+    def test_import_compact_json(self):
+        """Import of JSON objects however they are split into lines"""
+        self.t("import", input='[{"start":"20221210T000000Z","end":"20221210T010000Z","tags":["foo"]},'
+                               '{"start":"20221210T010000Z",\n"end":"20221210T020000Z",\n"tags":["b}a{r"]}]\n')
+
+        j = self.t.export()
+        self.assertEqual(len(j), 2)
+        self.assertClosedInterval(j[0], expectedStart="20221210T000000Z", expectedTags=["foo"])
+        self.assertClosedInterval(j[1], expectedStart="20221210T010000Z", expectedTags=["b}a{r"])
+
+    def test_import_incomplete_json(self):
+        """Import reports the line of an incomplete JSON object"""
+        code, out, err = self.t.runError("import", input='[\n{"start":"20221210T000000Z"},\n{"start":\n')
+        self.assertIn("Could not import line 3: the JSON object is incomplete.", err)
+        self.assertEqual(len(self.t.export()), 0)
+
+    def test_import_invalid_line(self):
+        """Import reports the line it cannot decode"""
+        code, out, err = self.t.runError("import", input="[\n{\"start\":\"20221210T000000Z\"},\nnot json\n]\n")
+        self.assertIn("Could not import line 3", err)
+
+    def test_undo_import(self):
+        """Undo of 'import' removes all imported intervals"""
+        self.t("import", input="inc 20221210T000000Z - 20221210T010000Z # foo\n"
+                               "inc 20230110T000000Z - 20230110T010000Z # bar\n")
+        self.assertEqual(len(self.t.export()), 2)
+
+        self.t("undo")
+        self.assertEqual(len(self.t.export()), 0)
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+
+    unittest.main(testRunner=TAPTestRunner())
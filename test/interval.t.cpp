@@ -31,7 +31,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (64);
+  UnitTest t (70);
 
   // bool is_started () const;
   // bool is_ended () const;
@@ -66,6 +66,15 @@ int main (int, char**)
   i2.untag ("foo");
   t.ok (i2.tags () == std::set <std::string> {"bar", "baz"}, "Interval(tag=bar,baz) -> {bar,baz}");
 
+  // bool hasTag (const std::string&) const;
+  // bool hasTags (const std::vector <TagDictionary::Id>&) const;
+  t.ok (i2.hasTag ("bar"), "Interval(tag=bar,baz).hasTag bar -> true");
+  t.notok (i2.hasTag ("foo"), "Interval(tag=bar,baz).hasTag foo -> false");
+  t.notok (i2.hasTag ("never-used"), "Interval(tag=bar,baz).hasTag never-used -> false");
+  t.ok (i2.hasTags (i2.tagIds ()), "Interval(tag=bar,baz).hasTags own tags -> true");
+  t.notok (i2.hasTags ({TagDictionary::intern ("foo")}), "Interval(tag=bar,baz).hasTags foo -> false");
+  t.ok (i2.hasTags ({TagDictionary::intern ("baz"), TagDictionary::intern ("bar")}), "Interval(tag=bar,baz).hasTags baz,bar -> true");
+
   // std::string serialize () const;
   Interval i3;
   t.is (i3.serialize (), "inc", "Interval.serialize -> 'inc'");
@@ -30,7 +30,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (8);
+  UnitTest t (18);
 
   Rules r;
   r.set ("string", "234");
@@ -54,6 +54,30 @@ int main (int, char**)
   t.ok ((int) r.all ().size () > 30,     "Rules all (\"\") --> >30");
   t.ok (r.all ("one.two").size () == 3,  "Rules all (\"one.two\") --> 3");
 
+  // Holidays are sorted by date, whatever their locale.
+  r.set ("holidays.eng-USA.2026_07_04", "Independence Day");
+  r.set ("holidays.deu-DEU.2026_10_03", "Tag der Deutschen Einheit");
+  r.set ("holidays.eng-USA.2026_01_01", "New Year's Day");
+  t.is ((int) r.holidays ().size (), 3,                                  "Rules holidays --> 3");
+  t.is (r.holidays ().begin ()->name, "New Year's Day",                  "Rules holidays [0] --> New Year's Day");
+  t.is (r.holidays ().begin ()->locale, "eng-USA",                       "Rules holidays [0] locale --> eng-USA");
+  t.ok (r.holidays ().contains (Datetime ("2026-07-04T12:00:00")),       "Rules holidays contains 2026-07-04T12:00:00");
+  t.notok (r.holidays ().contains (Datetime ("2026-07-05T00:00:00")),    "Rules holidays does not contain 2026-07-05");
+  t.is ((int) r.holidays ().within ({Datetime ("2026-07-04"), Datetime ("2026-10-03")}).size (), 2, "Rules holidays within 2026-07-04 - 2026-10-03 --> 2");
+
+  r.set ("holidays.eng-USA.2026_12_25", "Christmas Day");
+  t.is ((int) r.holidays ().size (), 4,                                  "Rules holidays after set --> 4");
+
+  // The exclusion fingerprint follows the holidays and exclusions only.
+  auto fingerprint = r.exclusionFingerprint ();
+  r.set ("one.two", 21);
+  t.is (r.exclusionFingerprint (), fingerprint,                          "Rules exclusionFingerprint unchanged by other settings");
+  r.set ("exclusions.friday", "<9:00:00");
+  t.ok (r.exclusionFingerprint () != fingerprint,                        "Rules exclusionFingerprint changed by exclusions");
+  fingerprint = r.exclusionFingerprint ();
+  r.set ("holidays.eng-USA.2026_11_26", "Thanksgiving");
+  t.ok (r.exclusionFingerprint () != fingerprint,                        "Rules exclusionFingerprint changed by holidays");
+
   return 0;
 }
 
@@ -217,6 +217,35 @@ class TestUndo(TestCase):
                                   expectedEnd=one_hour_before_utc,
                                   expectedTags=["foo"])
 
+    def test_undo_retag_multiple_ids(self):
+        """Test undo of command 'retag' with multiple ids"""
+        now_utc = datetime.now().utcnow()
+        one_hour_before_utc = now_utc - timedelta(hours=1)
+        two_hours_before_utc = now_utc - timedelta(hours=2)
+        three_hours_before_utc = now_utc - timedelta(hours=3)
+
+        self.t("track {:%Y%m%dT%H%M%SZ} - {:%Y%m%dT%H%M%SZ} foo".format(three_hours_before_utc, two_hours_before_utc))
+        self.t("track {:%Y%m%dT%H%M%SZ} - {:%Y%m%dT%H%M%SZ} foo".format(two_hours_before_utc, one_hour_before_utc))
+        self.t("retag @1 @2 bar")
+
+        j = self.t.export()
+        self.assertEqual(len(j), 2, msg="Expected 2 intervals before, got {}".format(len(j)))
+        self.assertEqual(j[0]['tags'], ["bar"])
+        self.assertEqual(j[1]['tags'], ["bar"])
+
+        self.t("undo")
+
+        j = self.t.export()
+        self.assertEqual(len(j), 2, msg="Expected 2 intervals afterwards, got {}".format(len(j)))
+        self.assertClosedInterval(j[0],
+                                  expectedStart=three_hours_before_utc,
+                                  expectedEnd=two_hours_before_utc,
+                                  expectedTags=["foo"])
+        self.assertClosedInterval(j[1],
+                                  expectedStart=two_hours_before_utc,
+                                  expectedEnd=one_hour_before_utc,
+                                  expectedTags=["foo"])
+
     # def test_undo_fill(self):
     # """Test undo of command 'fill 'Not yet implemented
     #   self.t("track {:%Y%m%dT%H%M%SZ} - {:%Y%m%dT%H%M%SZ} foo bar")
@@ -717,6 +746,89 @@ class TestUndo(TestCase):
         self.assertEqual(after_config, self.t("config"))
         self.assertEqual(after_c, self.t.export())
 
+    def test_undo_across_journal_segments(self):
+        """Test undo of the last journal.size commands when they span journal segments"""
+        self.t("config journal.size 3 :yes")
+
+        for hour in range(40):
+            start = datetime(2022, 12, 10) + timedelta(hours=hour)
+            self.t("track {:%Y%m%dT%H%M%SZ} - {:%Y%m%dT%H%M%SZ} foo".format(start, start + timedelta(minutes=30)))
+
+        datadir = os.path.join(self.t.env["TIMEWARRIORDB"], "data")
+        self.assertFalse(os.path.exists(os.path.join(datadir, "undo.0.data")))
+        self.assertTrue(os.path.exists(os.path.join(datadir, "undo.1.data")))
+
+        self.t("undo")
+        self.t("undo")
+        self.t("undo")
+        self.assertEqual(len(self.t.export()), 37)
+
+        code, out, err = self.t("undo")
+        self.assertIn("Nothing to undo.", out)
+        self.assertEqual(len(self.t.export()), 37)
+
+    def test_undo_single_file_journal(self):
+        """Test undo of a journal in the former single file format"""
+        self.t("track 2022-12-10T00:00:00Z - 2022-12-10T01:00:00Z foo")
+
+        datadir = os.path.join(self.t.env["TIMEWARRIORDB"], "data")
+        for name in os.listdir(datadir):
+            if name.startswith("undo."):
+                os.remove(os.path.join(datadir, name))
+
+        with open(os.path.join(datadir, "undo.data"), "w") as f:
+            f.write("txn:\n"
+                    "  type: interval\n"
+                    "  before: \n"
+                    "  after: {\"id\":1,\"start\":\"20221210T000000Z\",\"end\":\"20221210T010000Z\",\"tags\":[\"foo\"]}\n")
+
+        self.t("undo")
+
+        self.assertEqual(len(self.t.export()), 0)
+        self.assertFalse(os.path.exists(os.path.join(datadir, "undo.data")))
+
+    def test_undo_recovers_bounds_ahead_of_segment(self):
+        """Test undo when the journal bounds were committed but the segment append was not"""
+        self.t("track 2022-12-10T00:00:00Z - 2022-12-10T01:00:00Z foo")
+        self.t("track 2022-12-10T02:00:00Z - 2022-12-10T03:00:00Z foo")
+
+        datadir = os.path.join(self.t.env["TIMEWARRIORDB"], "data")
+        size = os.path.getsize(os.path.join(datadir, "undo.0.data"))
+        with open(os.path.join(datadir, "undo.segments"), "w") as f:
+            f.write("0 3 {}\n".format(size + 100))
+
+        self.t("undo")
+
+        self.assertEqual(len(self.t.export()), 1)
+
+        self.t("track 2022-12-10T04:00:00Z - 2022-12-10T05:00:00Z foo")
+        self.t("undo")
+        self.t("undo")
+
+        self.assertEqual(len(self.t.export()), 0)
+
+    def test_undo_records_changed_fields_only(self):
+        """Test that the journal records a modified interval as its start and the changed fields"""
+        self.t("track 2022-12-10T00:00:00Z - 2022-12-10T01:00:00Z foo")
+        self.t("tag @1 bar")
+
+        datadir = os.path.join(self.t.env["TIMEWARRIORDB"], "data")
+        with open(os.path.join(datadir, "undo.0.data")) as f:
+            journal = f.read()
+
+        self.assertTrue(journal.endswith("txn:\n  delta: 1\n  ~ 20221210T000000Z +\"bar\"\n"))
+
+        self.t("undo")
+
+        j = self.t.export()
+        self.assertEqual(len(j), 1)
+        self.assertClosedInterval(j[0], expectedTags=["foo"])
+
+        self.t("undo")
+
+        self.assertEqual(len(self.t.export()), 0)
+
+
 if __name__ == "__main__":
     from simpletap import TAPTestRunner
 